@@ -0,0 +1,114 @@
+// ChromeTrace.cpp
+#include "ChromeTrace.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    const char* argName;
+    long long argValue;
+    std::int64_t begin;
+    std::int64_t end;
+};
+
+// Events of one thread; only that thread appends until write()
+struct ThreadBuffer {
+    int id;
+    std::vector<Event> events;
+};
+
+struct Timeline {
+    std::mutex mutex;  // Guards the buffer list, not the buffers
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    std::string path;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+};
+
+// Never destroyed, so the trace can still be written from an atexit handler
+Timeline& timeline() {
+    static Timeline* instance = new Timeline();
+    return *instance;
+}
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+
+ThreadBuffer& localBuffer() {
+    if (!threadBuffer) {
+        Timeline& line = timeline();
+        std::lock_guard<std::mutex> lock(line.mutex);
+        line.threads.push_back(std::make_unique<ThreadBuffer>());
+        threadBuffer = line.threads.back().get();
+        threadBuffer->id = static_cast<int>(line.threads.size());
+        threadBuffer->events.reserve(1024);
+    }
+    return *threadBuffer;
+}
+
+std::string jsonEscape(const char* text) {
+    std::string escaped;
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') escaped += '\\';
+        escaped += *c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+std::atomic<bool> ChromeTrace::enabled(false);
+
+void ChromeTrace::setOutputPath(const std::string& path) {
+    Timeline& line = timeline();
+    line.path = path;
+    line.origin = std::chrono::steady_clock::now();
+    enabled.store(true, std::memory_order_release);
+}
+
+std::int64_t ChromeTrace::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - timeline().origin).count();
+}
+
+void ChromeTrace::record(const char* name, const char* category, const char* argName, long long argValue,
+                         std::int64_t begin, std::int64_t end) {
+    localBuffer().events.push_back({name, category, argName, argValue, begin, end});
+}
+
+void ChromeTrace::write() {
+    // Recording threads have been joined, so their buffers are complete
+    if (!enabled.exchange(false, std::memory_order_acq_rel)) return;
+
+    Timeline& line = timeline();
+    std::lock_guard<std::mutex> lock(line.mutex);
+
+    std::ofstream out(line.path);
+    if (!out) {
+        std::cerr << "Error: cannot write trace " << line.path << std::endl;
+        return;
+    }
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"hw4\"}}";
+    for (const auto& thread : line.threads) {
+        out << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread->id
+            << ", \"args\": {\"name\": \"thread " << thread->id << "\"}}";
+        for (const Event& event : thread->events) {
+            out << ",\n  {\"name\": \"" << jsonEscape(event.name) << "\", \"cat\": \"" << jsonEscape(event.category)
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread->id
+                << ", \"ts\": " << event.begin << ", \"dur\": " << event.end - event.begin;
+            if (event.argName) {
+                out << ", \"args\": {\"" << jsonEscape(event.argName) << "\": " << event.argValue << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Timeline of solver phases in the Chrome trace-event format
+ *
+ * When enabled with setOutputPath(), every ChromeTrace::Scope records one
+ * complete ("X") event with its thread, start and duration. write() saves
+ * them as JSON that chrome://tracing and ui.perfetto.dev load directly, so
+ * load imbalance between threads and serialized stretches show up as gaps.
+ *
+ * Each thread appends to its own buffer, so recording takes no lock; only a
+ * thread's first event registers its buffer. The buffers are merged when the
+ * trace is written at exit. Scopes are meant for phases (milliseconds and
+ * up), not for hot loops; a disabled scope only loads an atomic flag.
+ */
+class ChromeTrace {
+public:
+    /**
+     * @brief Records the lifetime of a scope as one event
+     */
+    class Scope {
+    public:
+        /**
+         * @param name Event name (must outlive the trace; use literals)
+         * @param category Event category, for filtering in the viewer
+         * @param argName Optional argument shown with the event (e.g. "start")
+         * @param argValue Value of the argument
+         */
+        Scope(const char* name, const char* category, const char* argName = nullptr, long long argValue = 0)
+            : name(name), category(category), argName(argName), argValue(argValue),
+              begin(enabled.load(std::memory_order_acquire) ? now() : 0) {
+        }
+        ~Scope() {
+            if (enabled.load(std::memory_order_acquire)) record(name, category, argName, argValue, begin, now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        const char* category;
+        const char* argName;
+        long long argValue;
+        std::int64_t begin;
+    };
+
+    // Enables recording; write() saves the trace to path
+    static void setOutputPath(const std::string& path);
+
+    /**
+     * Writes all recorded events and disables recording; suitable for std::atexit
+     *
+     * The thread buffers are read without synchronization, so this must run
+     * after every thread that recorded events has been joined.
+     */
+    static void write();
+
+    static bool isEnabled() { return enabled.load(std::memory_order_acquire); }
+
+private:
+    // Set with release after the timeline is set up, read with acquire by scopes
+    static std::atomic<bool> enabled;
+
+    // Microseconds since the trace was enabled
+    static std::int64_t now();
+
+    static void record(const char* name, const char* category, const char* argName, long long argValue,
+                       std::int64_t begin, std::int64_t end);
+};
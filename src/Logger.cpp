@@ -6,7 +6,7 @@
 // Specialization for ASFBStarTree::BStarNode
 template<>
 std::string Logger::nodeToString(ASFBStarTree::BStarNode* node) {
-    return "Module: " + node->moduleName;
+    return "Module: " + moduleName(node->module);
 }
 
 // Specialization for PlacementSolver::BStarNode
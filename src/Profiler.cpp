@@ -0,0 +1,328 @@
+// Profiler.cpp
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <sys/resource.h>
+#ifdef HW4_ALLOC_STATS
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Fixed capacity, so recording never reallocates (the allocation hook may
+// run in the middle of any other allocation)
+const int MAX_ZONES = 256;
+const int MAX_COUNTERS = 64;
+
+struct ZoneStats {
+    std::uint64_t calls = 0;
+    std::uint64_t total = 0;
+    std::uint64_t self = 0;
+    std::uint64_t allocations = 0;  // Made while this was the innermost zone
+    std::uint64_t allocatedBytes = 0;
+};
+
+// Stats of one thread; only that thread writes them until report()
+struct ThreadStats {
+    std::vector<ZoneStats> zones = std::vector<ZoneStats>(MAX_ZONES);
+    std::vector<std::uint64_t> counters = std::vector<std::uint64_t>(MAX_COUNTERS, 0);
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> zoneNames;
+    std::vector<std::string> counterNames;
+    std::vector<std::unique_ptr<ThreadStats>> threads;  // Outlive their threads
+    std::string reportPath;
+
+    // Calibration points for converting ticks to seconds
+    std::uint64_t startTicks = Profiler::ticks();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+};
+
+// Never destroyed, so the report can still run from an atexit handler
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+thread_local ThreadStats* threadStats = nullptr;
+thread_local Profiler::ScopedTimer* currentTimer = nullptr;
+thread_local int currentZone = -1;
+
+#ifdef HW4_ALLOC_STATS
+// Whole-process heap totals
+std::atomic<std::uint64_t> heapAllocations(0);
+std::atomic<std::uint64_t> heapBytes(0);
+std::atomic<std::int64_t> heapLive(0);
+std::atomic<std::int64_t> heapPeak(0);
+#endif
+
+ThreadStats& localStats() {
+    if (!threadStats) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.threads.push_back(std::make_unique<ThreadStats>());
+        threadStats = reg.threads.back().get();
+    }
+    return *threadStats;
+}
+
+int registerName(std::vector<std::string>& names, const char* name, int capacity) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) return static_cast<int>(it - names.begin());
+    if (static_cast<int>(names.size()) == capacity) {
+        std::cerr << "Profiler: too many zones or counters, dropping " << name << std::endl;
+        return -1;
+    }
+    names.push_back(name);
+    return static_cast<int>(names.size()) - 1;
+}
+
+double peakRssMegabytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return usage.ru_maxrss / 1024.0;  // Linux reports kilobytes
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+#ifdef HW4_ALLOC_STATS
+// Charges an allocation to the innermost zone of the calling thread. Runs
+// inside operator new, so it must not allocate or take the registry lock: a
+// thread without stats yet only counts toward the process totals.
+void recordAllocation(void* block) {
+    if (!block) return;
+    std::int64_t size = static_cast<std::int64_t>(malloc_usable_size(block));
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    std::int64_t live = heapLive.fetch_add(size, std::memory_order_relaxed) + size;
+    std::int64_t peak = heapPeak.load(std::memory_order_relaxed);
+    while (live > peak && !heapPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    if (threadStats && currentZone >= 0) {
+        ZoneStats& entry = threadStats->zones[currentZone];
+        entry.allocations++;
+        entry.allocatedBytes += size;
+    }
+}
+
+void recordRelease(void* block) {
+    if (block) heapLive.fetch_sub(static_cast<std::int64_t>(malloc_usable_size(block)), std::memory_order_relaxed);
+}
+
+void* allocate(std::size_t size) {
+    void* block = std::malloc(size ? size : 1);
+    if (!block) throw std::bad_alloc();
+    recordAllocation(block);
+    return block;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    void* block = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+    if (!block) throw std::bad_alloc();
+    recordAllocation(block);
+    return block;
+}
+
+void release(void* block) {
+    recordRelease(block);
+    std::free(block);
+}
+#endif
+
+} // namespace
+
+#ifdef HW4_ALLOC_STATS
+// Replaced global allocation functions; every other form forwards to these
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* block) noexcept { release(block); }
+void operator delete[](void* block) noexcept { release(block); }
+void operator delete(void* block, std::size_t) noexcept { release(block); }
+void operator delete[](void* block, std::size_t) noexcept { release(block); }
+void operator delete(void* block, std::align_val_t) noexcept { release(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { release(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { release(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { release(block); }
+#endif
+
+void Profiler::ScopedTimer::start(int zone) {
+    this->zone = zone;
+    childTicks = 0;
+    parent = currentTimer;
+    currentTimer = this;
+    currentZone = zone;
+    begin = ticks();
+}
+
+void Profiler::ScopedTimer::stop() {
+    std::uint64_t elapsed = ticks() - begin;
+    currentTimer = parent;
+    currentZone = parent ? parent->zone : -1;
+    if (parent) parent->childTicks += elapsed * weight;
+    record(zone, weight, elapsed * weight, (elapsed - std::min(elapsed, childTicks)) * weight);
+}
+
+int Profiler::registerZone(const char* name) {
+    return registerName(registry().zoneNames, name, MAX_ZONES);
+}
+
+int Profiler::registerCounter(const char* name) {
+    return registerName(registry().counterNames, name, MAX_COUNTERS);
+}
+
+void Profiler::record(int zone, std::uint64_t calls, std::uint64_t total, std::uint64_t self) {
+    if (zone < 0) return;
+    ZoneStats& entry = localStats().zones[zone];
+    entry.calls += calls;
+    entry.total += total;
+    entry.self += self;
+}
+
+void Profiler::count(int counter, std::uint64_t n) {
+    if (counter < 0) return;
+    localStats().counters[counter] += n;
+}
+
+void Profiler::setReportPath(const std::string& path) {
+    registry().reportPath = path;
+}
+
+void Profiler::report() {
+    Registry& reg = registry();
+#ifndef HW4_PROFILE
+    if (!reg.reportPath.empty()) {
+        std::cerr << "Profiler: built without PROFILE=1, no report written" << std::endl;
+    }
+    return;
+#endif
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    // Merge the threads
+    std::vector<ZoneStats> zones(MAX_ZONES);
+    std::vector<std::uint64_t> counters(MAX_COUNTERS, 0);
+    for (const auto& thread : reg.threads) {
+        for (size_t i = 0; i < thread->zones.size(); i++) {
+            zones[i].calls += thread->zones[i].calls;
+            zones[i].total += thread->zones[i].total;
+            zones[i].self += thread->zones[i].self;
+            zones[i].allocations += thread->zones[i].allocations;
+            zones[i].allocatedBytes += thread->zones[i].allocatedBytes;
+        }
+        for (size_t i = 0; i < thread->counters.size(); i++) {
+            counters[i] += thread->counters[i];
+        }
+    }
+
+    // Calibrate ticks against the steady clock over the whole run
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - reg.startTime).count();
+    std::uint64_t wallTicks = ticks() - reg.startTicks;
+    double secondsPerTick = wallTicks > 0 ? wallSeconds / wallTicks : 0.0;
+
+    // Busiest zones first
+    std::vector<size_t> order(reg.zoneNames.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return zones[a].total > zones[b].total; });
+
+    std::ostream& out = std::cerr;
+    out << "\nProfile (" << std::fixed << std::setprecision(3) << wallSeconds << " s wall, "
+        << reg.threads.size() << " thread(s))\n";
+    out << std::left << std::setw(52) << "zone" << std::right
+        << std::setw(12) << "calls" << std::setw(14) << "total ms" << std::setw(14) << "self ms"
+        << std::setw(14) << "avg us" << std::setw(8) << "%wall";
+#ifdef HW4_ALLOC_STATS
+    out << std::setw(12) << "allocs" << std::setw(14) << "alloc KB";
+#endif
+    out << "\n";
+    std::uint64_t zoneAllocations = 0;
+    std::uint64_t zoneBytes = 0;
+    for (size_t i : order) {
+        const ZoneStats& zone = zones[i];
+        zoneAllocations += zone.allocations;
+        zoneBytes += zone.allocatedBytes;
+        if (zone.calls == 0) continue;
+        double total = zone.total * secondsPerTick;
+        out << std::left << std::setw(52) << reg.zoneNames[i] << std::right
+            << std::setw(12) << zone.calls
+            << std::setw(14) << std::setprecision(1) << total * 1e3
+            << std::setw(14) << zone.self * secondsPerTick * 1e3
+            << std::setw(14) << std::setprecision(2) << total * 1e6 / zone.calls
+            << std::setw(8) << std::setprecision(1) << (wallSeconds > 0 ? 100.0 * total / wallSeconds : 0.0);
+#ifdef HW4_ALLOC_STATS
+        out << std::setw(12) << zone.allocations << std::setw(14) << zone.allocatedBytes / 1024.0;
+#endif
+        out << "\n";
+    }
+    for (size_t i = 0; i < reg.counterNames.size(); i++) {
+        out << std::left << std::setw(52) << reg.counterNames[i] << std::right << std::setw(12) << counters[i] << "\n";
+    }
+#ifdef HW4_ALLOC_STATS
+    // Allocations made outside every zone (static init, option parsing, threads without stats)
+    std::uint64_t allocations = heapAllocations.load();
+    std::uint64_t allocatedBytes = heapBytes.load();
+    out << std::left << std::setw(52) << "(outside zones)" << std::right << std::setw(74)
+        << allocations - std::min(allocations, zoneAllocations)
+        << std::setw(14) << std::setprecision(1) << (allocatedBytes - std::min(allocatedBytes, zoneBytes)) / 1024.0 << "\n";
+    out << "Heap: " << allocations << " allocations, " << std::setprecision(1) << allocatedBytes / 1048576.0
+        << " MB allocated, " << heapPeak.load() / 1048576.0 << " MB peak live\n";
+#endif
+    double peakRss = peakRssMegabytes();
+    out << "Peak RSS: " << std::setprecision(1) << peakRss << " MB\n";
+    out << std::flush;
+
+    if (reg.reportPath.empty()) return;
+
+    std::ofstream json(reg.reportPath);
+    if (!json) {
+        std::cerr << "Profiler: cannot write " << reg.reportPath << std::endl;
+        return;
+    }
+    json << std::setprecision(9);
+    json << "{\n  \"wallSeconds\": " << wallSeconds << ",\n  \"threads\": " << reg.threads.size()
+         << ",\n  \"peakRssMegabytes\": " << peakRss;
+#ifdef HW4_ALLOC_STATS
+    json << ",\n  \"heap\": {\"allocations\": " << allocations << ", \"allocatedBytes\": " << allocatedBytes
+         << ", \"peakLiveBytes\": " << heapPeak.load() << "}";
+#endif
+    json << ",\n  \"zones\": [";
+    bool first = true;
+    for (size_t i : order) {
+        if (zones[i].calls == 0) continue;
+        json << (first ? "\n" : ",\n") << "    {\"name\": \"" << jsonEscape(reg.zoneNames[i])
+             << "\", \"calls\": " << zones[i].calls
+             << ", \"totalSeconds\": " << zones[i].total * secondsPerTick
+             << ", \"selfSeconds\": " << zones[i].self * secondsPerTick;
+#ifdef HW4_ALLOC_STATS
+        json << ", \"allocations\": " << zones[i].allocations << ", \"allocatedBytes\": " << zones[i].allocatedBytes;
+#endif
+        json << "}";
+        first = false;
+    }
+    json << "\n  ],\n  \"counters\": {";
+    for (size_t i = 0; i < reg.counterNames.size(); i++) {
+        json << (i ? ",\n" : "\n") << "    \"" << jsonEscape(reg.counterNames[i]) << "\": " << counters[i];
+    }
+    json << "\n  }\n}\n";
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Built-in profiler: scoped timers and counters, merged over threads
+ *
+ * Compiled in with `make PROFILE=1` (defines HW4_PROFILE). Without it the
+ * HW4_PROFILE_* macros expand to nothing, so instrumented code pays no cost.
+ *
+ * Each instrumented site registers its name once (a function-local static)
+ * and then only touches thread-local arrays, so timing a zone costs two
+ * cycle-counter reads and a few adds. Zones nest: a zone's self time excludes
+ * the time spent in zones opened inside it. At exit, report() prints a table
+ * to stderr and, if a path was set, writes the same data as JSON.
+ *
+ * Zones around very short, very frequent calls (well under a microsecond)
+ * should be sampled: the counter reads alone would otherwise cost more than
+ * the 1% budget. A sampled zone times one call in `period` and weighs it by
+ * `period`, so its calls and times are estimates.
+ *
+ * `make ALLOC_STATS=1` (defines HW4_ALLOC_STATS as well) also replaces the
+ * global operator new/delete: every allocation is charged to the innermost
+ * open zone, and the report adds allocation counts and bytes per zone, the
+ * process's heap totals and peak live heap. Sampled zones are timed on every
+ * call in this mode so that no allocation is charged to their parent. All
+ * profiling builds report the peak resident set size.
+ */
+class Profiler {
+public:
+    /**
+     * @brief Times one zone from construction to destruction
+     * 
+     * The recorded time and call count are multiplied by weight; a weight of
+     * 0 skips the call (a sampled zone between samples).
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(int zone, unsigned weight = 1) : weight(weight) {
+            if (weight) start(zone);
+        }
+        ~ScopedTimer() {
+            if (weight) stop();
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        // Closes the current zone and opens another one, for sequential stages
+        void next(int zone) {
+            if (weight) stop();
+            weight = 1;
+            start(zone);
+        }
+
+    private:
+        void start(int zone);
+        void stop();
+
+        unsigned weight;
+        int zone;
+        std::uint64_t begin;
+        std::uint64_t childTicks;
+        ScopedTimer* parent;
+    };
+
+    // Returns the id of a zone or counter name, registering it on first use;
+    // -1 once the table is full, and timing or counting id -1 does nothing
+    static int registerZone(const char* name);
+    static int registerCounter(const char* name);
+
+    // Adds n to a counter on the calling thread
+    static void count(int counter, std::uint64_t n);
+
+    // JSON report destination; the table always goes to stderr
+    static void setReportPath(const std::string& path);
+
+    // Merges all threads and writes the report; suitable for std::atexit
+    static void report();
+
+    static std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+private:
+    static void record(int zone, std::uint64_t calls, std::uint64_t total, std::uint64_t self);
+};
+
+#define HW4_PROFILE_CONCAT_(a, b) a##b
+#define HW4_PROFILE_CONCAT(a, b) HW4_PROFILE_CONCAT_(a, b)
+
+#ifdef HW4_PROFILE
+
+// Times the rest of the enclosing scope as zone `name`
+#define HW4_PROFILE_SCOPE(name) \
+    static const int HW4_PROFILE_CONCAT(profileZone_, __LINE__) = Profiler::registerZone(name); \
+    Profiler::ScopedTimer HW4_PROFILE_CONCAT(profileTimer_, __LINE__)(HW4_PROFILE_CONCAT(profileZone_, __LINE__))
+
+#ifdef HW4_ALLOC_STATS
+#define HW4_PROFILE_SAMPLE_PERIOD(period) 1u
+#else
+#define HW4_PROFILE_SAMPLE_PERIOD(period) (period)
+#endif
+
+// Like HW4_PROFILE_SCOPE, but times only every period-th call on each thread
+#define HW4_PROFILE_SCOPE_SAMPLED(name, period) \
+    static const int HW4_PROFILE_CONCAT(profileZone_, __LINE__) = Profiler::registerZone(name); \
+    static thread_local unsigned HW4_PROFILE_CONCAT(profileSample_, __LINE__) = 0; \
+    Profiler::ScopedTimer HW4_PROFILE_CONCAT(profileTimer_, __LINE__)( \
+        HW4_PROFILE_CONCAT(profileZone_, __LINE__), \
+        ++HW4_PROFILE_CONCAT(profileSample_, __LINE__) % HW4_PROFILE_SAMPLE_PERIOD(period) == 0 \
+            ? HW4_PROFILE_SAMPLE_PERIOD(period) : 0)
+
+// Declares a named timer for sequential stages of one function
+#define HW4_PROFILE_STAGE(timer, name) \
+    static const int HW4_PROFILE_CONCAT(profileZone_, __LINE__) = Profiler::registerZone(name); \
+    Profiler::ScopedTimer timer(HW4_PROFILE_CONCAT(profileZone_, __LINE__))
+
+// Ends the timer's current stage and starts the next one
+#define HW4_PROFILE_NEXT_STAGE(timer, name) \
+    do { \
+        static const int profileZone = Profiler::registerZone(name); \
+        timer.next(profileZone); \
+    } while (0)
+
+// Adds n to counter `name`
+#define HW4_PROFILE_COUNT(name, n) \
+    do { \
+        static const int profileCounter = Profiler::registerCounter(name); \
+        Profiler::count(profileCounter, static_cast<std::uint64_t>(n)); \
+    } while (0)
+
+#else
+
+#define HW4_PROFILE_SCOPE(name) do {} while (0)
+#define HW4_PROFILE_SCOPE_SAMPLED(name, period) do {} while (0)
+#define HW4_PROFILE_STAGE(timer, name) do {} while (0)
+#define HW4_PROFILE_NEXT_STAGE(timer, name) do {} while (0)
+#define HW4_PROFILE_COUNT(name, n) do {} while (0)
+
+#endif
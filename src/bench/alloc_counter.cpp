@@ -0,0 +1,46 @@
+// alloc_counter.cpp
+
+#include "alloc_counter.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef HW4_ALLOC_STATS
+#error "the microbenchmarks count allocations themselves; build them without ALLOC_STATS=1"
+#endif
+
+namespace {
+unsigned long long allocationCount = 0;
+unsigned long long allocationBytes = 0;
+
+void* countedAlloc(std::size_t size, std::size_t alignment) {
+    allocationCount++;
+    allocationBytes += size;
+    void* p = alignment > alignof(std::max_align_t)
+        ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+        : std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+} // namespace
+
+unsigned long long AllocCounter::count() { return allocationCount; }
+unsigned long long AllocCounter::bytes() { return allocationBytes; }
+
+void* operator new(std::size_t size) { return countedAlloc(size, 0); }
+void* operator new[](std::size_t size) { return countedAlloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,16 @@
+// alloc_counter.hpp
+#pragma once
+
+/**
+ * @brief Heap allocation counts of the microbenchmarks
+ *
+ * alloc_counter.cpp replaces the global operator new/delete with versions
+ * that count every allocation. They live in their own translation unit so
+ * the compiler never inlines them into callers, where it would pair a
+ * new-expression with the free() inside operator delete.
+ */
+namespace AllocCounter {
+    // Allocations and bytes requested since the program started
+    unsigned long long count();
+    unsigned long long bytes();
+}
@@ -0,0 +1,337 @@
+// microbench.cpp
+//
+// Microbenchmarks of the placer's inner kernels on reproducible synthetic
+// inputs. Build with `make microbench` and run
+//
+//     ../bin/microbench [filter]
+//
+// to time every kernel whose name contains filter. Each kernel is warmed up,
+// then timed over REPETITIONS batches sized to take about BATCH_SECONDS
+// each; the table reports the median, minimum and median absolute deviation
+// of the per-operation time, and the heap allocations per operation counted
+// by the replaced global operator new (alloc_counter.cpp).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../data_struct/ASFBStarTree.hpp"
+#include "../data_struct/BStarTree.hpp"
+#include "../data_struct/Contour.hpp"
+#include "../data_struct/GeometryStore.hpp"
+#include "../data_struct/Module.hpp"
+#include "../data_struct/OverlapDetector.hpp"
+#include "../data_struct/SymbolTable.hpp"
+#include "../data_struct/SymmetryConstraint.hpp"
+#include "../slicing/slicing_sa.hpp"
+#include "../slicing/slicing_struct.hpp"
+#include "../Logger.hpp"
+#include "alloc_counter.hpp"
+
+/********************************************************************
+ * Harness
+ ********************************************************************/
+
+namespace {
+
+const int WARMUP_BATCHES = 3;
+const int REPETITIONS = 15;
+const double BATCH_SECONDS = 0.01;
+
+std::string filter;
+
+// Keeps results alive so the compiler cannot drop the work
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+double secondsOf(const std::function<void()>& op, long ops) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ops; i++) op();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Times op (one operation per call) and prints one table row
+ */
+void bench(const std::string& name, const std::function<void()>& op) {
+    if (name.find(filter) == std::string::npos) return;
+
+    // Grow the batch until it takes long enough to time reliably
+    long ops = 1;
+    while (secondsOf(op, ops) < BATCH_SECONDS && ops < (1L << 30)) ops *= 2;
+    for (int i = 0; i < WARMUP_BATCHES; i++) secondsOf(op, ops);
+
+    std::vector<double> nsPerOp;
+    unsigned long long allocationsBefore = AllocCounter::count();
+    unsigned long long bytesBefore = AllocCounter::bytes();
+    for (int i = 0; i < REPETITIONS; i++) {
+        nsPerOp.push_back(secondsOf(op, ops) * 1e9 / ops);
+    }
+    // nsPerOp's own growth is a handful of allocations over millions of ops
+    double totalOps = static_cast<double>(ops) * REPETITIONS;
+    double allocations = (AllocCounter::count() - allocationsBefore) / totalOps;
+    double bytes = (AllocCounter::bytes() - bytesBefore) / totalOps;
+
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    double median = nsPerOp[REPETITIONS / 2];
+    std::vector<double> deviations;
+    for (double ns : nsPerOp) deviations.push_back(std::abs(ns - median));
+    std::sort(deviations.begin(), deviations.end());
+
+    std::printf("%-52s %12.1f %12.1f %10.1f %10.2f %12.1f\n", name.c_str(), median, nsPerOp.front(),
+                deviations[REPETITIONS / 2], allocations, bytes);
+    std::fflush(stdout);
+}
+
+/********************************************************************
+ * Kernels
+ ********************************************************************/
+
+// Leaf node holding a staircase shape curve of n records
+std::shared_ptr<SlicingTreeNode> curveNode(int n, int step) {
+    auto node = std::make_shared<SlicingTreeNode>();
+    for (int i = 0; i < n; i++) {
+        node->shapeRecords.emplace_back(10 + i * step, 10 + (n - i) * step, i, i);
+    }
+    return node;
+}
+
+void benchShapeCurves() {
+    for (int size = 2; size <= 512; size *= 2) {
+        for (int type : {SlicingTreeNode::VERTICAL_CUT, SlicingTreeNode::HORIZONTAL_CUT}) {
+            SlicingTreeNode cut(type);
+            cut.leftChild = curveNode(size, 3);
+            cut.rightChild = curveNode(size, 5);
+            std::string name = std::string("updateShapeRecords/") +
+                (type == SlicingTreeNode::VERTICAL_CUT ? "V/" : "H/") + std::to_string(size);
+            bench(name, [&]() {
+                cut.updateShapeRecords();
+                keep(cut.shapeRecords.size());
+            });
+        }
+    }
+}
+
+void benchSegmentTree() {
+    for (size_t n : {1024UL, 65536UL}) {
+        std::mt19937 rng(1);
+        std::vector<std::pair<size_t, size_t>> ranges(4096);
+        for (auto& range : ranges) {
+            size_t a = rng() % n, b = rng() % n;
+            range = {std::min(a, b), std::max(a, b)};
+        }
+        SegmentTree<int> tree;
+        tree.init(n);
+        size_t next = 0;
+        bench("SegmentTree/update/" + std::to_string(n), [&]() {
+            const auto& range = ranges[next++ & 4095];
+            tree.update(range.first, range.second, static_cast<int>(next & 1023));
+        });
+        bench("SegmentTree/query/" + std::to_string(n), [&]() {
+            const auto& range = ranges[next++ & 4095];
+            keep(tree.query(range.first, range.second));
+        });
+    }
+}
+
+/**
+ * One skyline pack: every block drops onto the contour at its x
+ */
+struct PackInput {
+    std::vector<int> x, width, height;
+    int span;
+};
+
+PackInput packInput(int blocks) {
+    std::mt19937 rng(2);
+    PackInput input;
+    input.span = 40 * blocks;
+    for (int i = 0; i < blocks; i++) {
+        int width = 10 + static_cast<int>(rng() % 90);
+        input.width.push_back(width);
+        input.height.push_back(10 + static_cast<int>(rng() % 90));
+        input.x.push_back(static_cast<int>(rng() % (input.span - width)));
+    }
+    return input;
+}
+
+void benchContours() {
+    for (int blocks : {64, 1024}) {
+        PackInput input = packInput(blocks);
+        std::string suffix = "/" + std::to_string(blocks);
+
+        Contour contour;
+        std::vector<int> breakpoints;
+        bench("contour pack/Contour" + suffix, [&]() {
+            breakpoints.clear();
+            for (int i = 0; i < blocks; i++) {
+                breakpoints.push_back(input.x[i]);
+                breakpoints.push_back(input.x[i] + input.width[i]);
+            }
+            contour.reset(breakpoints);
+            for (int i = 0; i < blocks; i++) {
+                int x2 = input.x[i] + input.width[i];
+                int y = contour.maxHeight(input.x[i], x2);
+                contour.assign(input.x[i], x2, y + input.height[i]);
+            }
+            keep(contour.heightAt(0));
+        });
+
+        // Uncompressed x-axis in the course's segment tree
+        SegmentTree<int> tree;
+        bench("contour pack/SegmentTree" + suffix, [&]() {
+            tree.init(input.span);
+            for (int i = 0; i < blocks; i++) {
+                int x2 = input.x[i] + input.width[i] - 1;
+                int y = tree.query(input.x[i], x2);
+                tree.update(input.x[i], x2, y + input.height[i]);
+            }
+            keep(tree.query(0, 0));
+        });
+
+        // One height per unit of x, scanned linearly
+        std::vector<int> skyline;
+        bench("contour pack/flat array" + suffix, [&]() {
+            skyline.assign(input.span, 0);
+            for (int i = 0; i < blocks; i++) {
+                auto first = skyline.begin() + input.x[i];
+                auto last = first + input.width[i];
+                int y = *std::max_element(first, last);
+                std::fill(first, last, y + input.height[i]);
+            }
+            keep(skyline[0]);
+        });
+    }
+}
+
+void benchSymmetryIsland() {
+    for (int pairs : {4, 32}) {
+        std::mt19937 rng(3);
+        SymbolTable& symbols = SymbolTable::modules();
+        auto geometry = std::make_shared<GeometryStore>();
+        std::map<ModuleId, std::shared_ptr<Module>> modules;
+        auto group = std::make_shared<SymmetryGroup>("bench" + std::to_string(pairs));
+        auto addModule = [&](const std::string& name, int width, int height) {
+            ModuleId id = symbols.intern(name);
+            modules[id] = std::make_shared<Module>(geometry, id, width, height);
+            return id;
+        };
+        for (int i = 0; i < pairs; i++) {
+            int width = 10 + static_cast<int>(rng() % 40);
+            int height = 10 + static_cast<int>(rng() % 40);
+            std::string prefix = "p" + std::to_string(pairs) + "_" + std::to_string(i);
+            group->addSymmetryPair(addModule(prefix + "a", width, height), addModule(prefix + "b", width, height));
+        }
+        for (int i = 0; i < 2; i++) {
+            group->addSelfSymmetric(addModule("s" + std::to_string(pairs) + "_" + std::to_string(i),
+                                              20 + 10 * i, 16));
+        }
+
+        ASFBStarTree tree(group, modules);
+        tree.pack();
+        std::string suffix = "/" + std::to_string(pairs) + " pairs";
+        bench("ASFBStarTree::updateSymmetricModulePositions" + suffix, [&]() {
+            tree.updateSymmetricModulePositions();
+        });
+        bench("ASFBStarTree::pack" + suffix, [&]() {
+            keep(tree.pack());
+        });
+    }
+}
+
+} // namespace
+
+/**
+ * Times the Polish-expression moves on SimulatedAnnealing's initial expressions
+ */
+class MicroBench {
+public:
+    static void perturbExpression() {
+        for (int blocks : {16, 256}) {
+            std::mt19937 rng(4);
+            FloorplanData data;
+            for (int i = 0; i < blocks; i++) {
+                data.addBlock("b" + std::to_string(i), 10 + static_cast<int>(rng() % 90),
+                              10 + static_cast<int>(rng() % 90));
+            }
+            SimulatedAnnealing annealer(&data);
+            std::srand(5);
+            PolishExpression expression(annealer.generateInitialExpression());
+            for (int move = 0; move < 3; move++) {
+                bench("perturbExpression/M" + std::to_string(move + 1) + "/" + std::to_string(blocks), [&]() {
+                    expression.perturb(move);
+                });
+                bench("perturbExpression/M" + std::to_string(move + 1) + "+undo/" + std::to_string(blocks), [&]() {
+                    expression.apply(expression.perturb(move));
+                });
+            }
+        }
+    }
+};
+
+namespace {
+
+void benchOverlaps() {
+    for (int rects : {64, 1024}) {
+        // A non-overlapping grid: the worst case, since no check can stop early
+        std::vector<int> x, y, width, height;
+        int columns = 32;
+        for (int i = 0; i < rects; i++) {
+            x.push_back((i % columns) * 100);
+            y.push_back((i / columns) * 100);
+            width.push_back(50 + i % 50);
+            height.push_back(50 + (i * 7) % 50);
+        }
+        std::string suffix = "/" + std::to_string(rects);
+
+        OverlapDetector detector;
+        bench("overlap check/sweep" + suffix, [&]() {
+            detector.clear();
+            for (int i = 0; i < rects; i++) detector.addRect(i, x[i], y[i], width[i], height[i]);
+            keep(detector.hasOverlap());
+        });
+
+        bench("overlap check/all pairs" + suffix, [&]() {
+            bool overlap = false;
+            for (int i = 0; i < rects && !overlap; i++) {
+                for (int j = i + 1; j < rects; j++) {
+                    if (x[i] < x[j] + width[j] && x[j] < x[i] + width[i] &&
+                        y[i] < y[j] + height[j] && y[j] < y[i] + height[i]) {
+                        overlap = true;
+                        break;
+                    }
+                }
+            }
+            keep(overlap);
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) filter = argv[1];
+
+    // Keep the kernels' logging work but write nothing to the working directory
+    Logger::init("/dev/null");
+    SimulatedAnnealing::setDebugLogPath("");
+
+    std::printf("%-52s %12s %12s %10s %10s %12s\n", "kernel", "median ns", "min ns", "MAD ns", "allocs/op",
+                "bytes/op");
+    benchShapeCurves();
+    benchSegmentTree();
+    benchContours();
+    benchSymmetryIsland();
+    MicroBench::perturbExpression();
+    benchOverlaps();
+    return 0;
+}
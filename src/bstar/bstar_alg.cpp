@@ -0,0 +1,199 @@
+#include "bstar_sa.hpp"
+#include "../Logger.hpp"
+#include "../ChromeTrace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+BStarTreeAnnealer::BStarTreeAnnealer(FloorplanData* data)
+    : data(data), outline(data->getOutline()), wirelengthModel(nullptr), areaWeight(1.0), wirelengthWeight(0.0),
+      timeLimit(230.0), initialAcceptance(0.9), hasInitialTree(false), traceEngine("bstar"), traceStart(0),
+      moveSelector({0.2, 0.4, 0.4}), bestArea(std::numeric_limits<Area>::max()), moveCount(0) {
+
+    int n = data->getNumBlocks();
+    widths.resize(n);
+    heights.resize(n);
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) {
+        widths[i] = data->getBlock(i)->getWidth();
+        heights[i] = data->getBlock(i)->getHeight();
+        order[i] = i;
+    }
+    current.reset(order);
+}
+
+BStarTreeAnnealer::BStarTreeAnnealer(const std::vector<int>& widths, const std::vector<int>& heights)
+    : data(nullptr), widths(widths), heights(heights), wirelengthModel(nullptr),
+      areaWeight(1.0), wirelengthWeight(0.0), timeLimit(230.0), initialAcceptance(0.9),
+      hasInitialTree(false), traceEngine("bstar"), traceStart(0), moveSelector({0.2, 0.4, 0.4}),
+      bestArea(std::numeric_limits<Area>::max()), moveCount(0) {
+
+    std::vector<int> order(widths.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+    current.reset(order);
+}
+
+void BStarTreeAnnealer::setInitialTree(const BStarArrayTree& tree) {
+    current = tree;
+    hasInitialTree = true;
+}
+
+void BStarTreeAnnealer::setInitialAcceptance(double probability) {
+    initialAcceptance = probability;
+}
+
+void BStarTreeAnnealer::setTraceRun(const char* engine, int start) {
+    traceEngine = engine;
+    traceStart = start;
+}
+
+void BStarTreeAnnealer::setTimeLimit(double seconds) {
+    timeLimit = seconds;
+}
+
+void BStarTreeAnnealer::setOutline(const Outline& outline) {
+    this->outline = outline;
+}
+
+void BStarTreeAnnealer::setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight) {
+    // Without nets or weight the cost stays the plain area
+    if (model && model->empty()) model = nullptr;
+    if (wirelengthWeight <= 0.0) model = nullptr;
+
+    wirelengthModel = model;
+    this->areaWeight = areaWeight;
+    this->wirelengthWeight = wirelengthWeight;
+}
+
+double BStarTreeAnnealer::evaluate(Area& area) {
+    current.pack(widths, heights);
+    area = areaOf(current.getPackedWidth(), current.getPackedHeight());
+
+    // Area outside a fixed outline is penalized (no-op without one)
+    Area areaCost = outline.cost(current.getPackedWidth(), current.getPackedHeight());
+    if (!wirelengthModel) {
+        return areaCost;
+    }
+
+    for (int i = 0; i < current.size(); i++) {
+        wirelengthModel->moveObject(i, current.getX(i), current.getY(i), current.isRotated(i));
+    }
+    return areaWeight * areaCost + wirelengthWeight * wirelengthModel->evaluate();
+}
+
+void BStarTreeAnnealer::randomMove(int type) {
+    int n = current.size();
+    int first = std::rand() % n;
+    int second = std::rand() % (n - 1);
+    if (second >= first) second++;
+
+    switch (type) {
+        case ROTATE: current.rotate(first); break;
+        case SWAP:   current.swapBlocks(first, second); break;
+        case MOVE:   current.moveBlock(first, second, std::rand() % 2 == 0); break;
+    }
+}
+
+void BStarTreeAnnealer::sampleMoves(AnnealingSchedule& schedule, double cost) {
+    // Capped: on large trees every sample is a full O(n log n) pack
+    int samples = std::min(400, std::max(50, 4 * current.size()));
+
+    for (int i = 0; i < samples; i++) {
+        randomMove(moveSelector.select());
+        Area area;
+        schedule.sample(evaluate(area) - cost);
+        current.undo();
+    }
+}
+
+void BStarTreeAnnealer::applyToBlocks(BStarArrayTree& solution) {
+    solution.pack(widths, heights);
+    if (!data) return;
+    for (int i = 0; i < solution.size(); i++) {
+        Block* block = data->getBlock(i);
+        block->setX(solution.getX(i));
+        block->setY(solution.getY(i));
+        block->setRotated(solution.isRotated(i));
+    }
+}
+
+void BStarTreeAnnealer::run() {
+    ChromeTrace::Scope timelineTrace(traceEngine, "anneal", "start", traceStart);
+    AnnealingSchedule schedule(timeLimit, initialAcceptance);
+    int n = current.size();
+
+    Logger::log("B*-tree annealing over " + std::to_string(n) + " blocks");
+
+    if (n < 2) {
+        best = current;
+        applyToBlocks(best);
+        bestArea = areaOf(best.getPackedWidth(), best.getPackedHeight());
+        return;
+    }
+
+    // Random initial tree unless refining a given one
+    if (!hasInitialTree) {
+        std::vector<int> order(n);
+        for (int i = 0; i < n; i++) order[i] = i;
+        for (int i = n - 1; i > 0; i--) {
+            std::swap(order[i], order[std::rand() % (i + 1)]);
+        }
+        current.reset(order);
+    }
+
+    Area area;
+    double cost = evaluate(area);
+    best = current;
+    double bestCost = cost;
+    bestArea = area;
+
+    // Accept an average uphill move with probability initialAcceptance at the
+    // start, and cool to the end of the budget
+    sampleMoves(schedule, cost);
+    schedule.calibrate();
+
+    AnnealingTrace trace(traceEngine, traceStart, schedule);
+    const int checkInterval = 256;
+
+    while (true) {
+        if (moveCount % checkInterval == 0) {
+            if (!schedule.update()) break;
+            trace.update(cost, bestCost);
+        }
+        moveCount++;
+
+        int type = moveSelector.select();
+        auto moveStart = std::chrono::steady_clock::now();
+        randomMove(type);
+
+        Area newArea;
+        double newCost = evaluate(newArea);
+        double delta = newCost - cost;
+
+        bool accepted = schedule.accept(delta);
+        moveSelector.record(type, delta, accepted,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - moveStart).count(),
+            schedule.getTemperature());
+        trace.move(delta, accepted);
+
+        if (accepted) {
+            current.commit();
+            cost = newCost;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestArea = newArea;
+                best = current;
+            }
+        } else {
+            current.undo();
+        }
+    }
+
+    applyToBlocks(best);
+
+    Logger::log("B*-tree annealing finished: area " + std::to_string(bestArea) + ", " +
+        std::to_string(moveCount) + " moves in " + std::to_string(schedule.getElapsed()) + " s, " +
+        "rotate/swap/move " + moveSelector.describe());
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "bstar_struct.hpp"
+#include "../slicing/slicing_struct.hpp"
+#include "../data_struct/HPWLEvaluator.hpp"
+#include "../data_struct/MoveSelector.hpp"
+#include "../data_struct/AnnealingSchedule.hpp"
+#include "../data_struct/AnnealingTrace.hpp"
+#include <vector>
+
+/**
+ * @brief Simulated annealing over an array-based B*-tree
+ *
+ * Works on the same FloorplanData blocks (regular modules and symmetry
+ * islands) as the slicing annealer and leaves the best packing in the
+ * blocks' positions and rotation flags.
+ *
+ * Moves are rotations, block swaps and delete-and-insert of a node. They are
+ * journaled by the tree, so a rejected move is undone without repacking
+ * bookkeeping or copying the tree. A MoveSelector adapts the mix of move
+ * types to what pays off during the run. The temperature starts from the average
+ * uphill cost of random moves and decays geometrically over the time budget.
+ */
+class BStarTreeAnnealer {
+public:
+    BStarTreeAnnealer(FloorplanData* data);
+
+    /**
+     * Anneals bare rectangles; the result is only available as getBestTree()
+     */
+    BStarTreeAnnealer(const std::vector<int>& widths, const std::vector<int>& heights);
+
+    // Wall-clock budget of run() in seconds
+    void setTimeLimit(double seconds);
+
+    // Fixed outline to pack into (defaults to the FloorplanData's, if any)
+    void setOutline(const Outline& outline);
+
+    // Add weighted wirelength to the cost; model objects are block indices
+    void setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight);
+
+    // Start from this tree instead of a random one (for refinement)
+    void setInitialTree(const BStarArrayTree& tree);
+
+    // Probability of accepting an average uphill move at the start (default 0.9)
+    void setInitialAcceptance(double probability);
+
+    // Engine name and start index of this run's trace records (default "bstar", 0)
+    void setTraceRun(const char* engine, int start);
+
+    // Anneal and write the best packing to the blocks
+    void run();
+
+    const BStarArrayTree& getBestTree() const { return best; }
+    Area getBestArea() const { return bestArea; }
+    long long getMoveCount() const { return moveCount; }
+
+private:
+    enum MoveType {
+        ROTATE,
+        SWAP,
+        MOVE
+    };
+
+    FloorplanData* data;
+    BStarArrayTree current;
+    BStarArrayTree best;
+    std::vector<int> widths;
+    std::vector<int> heights;
+    Outline outline;
+
+    HPWLEvaluator* wirelengthModel;
+    double areaWeight;
+    double wirelengthWeight;
+    double timeLimit;
+    double initialAcceptance;
+    bool hasInitialTree;
+    const char* traceEngine;
+    int traceStart;
+
+    MoveSelector moveSelector;
+    Area bestArea;
+    long long moveCount;
+
+    // Packs the current tree and returns its cost
+    double evaluate(Area& area);
+
+    // Applies a random move of the given type to the current tree (journaled)
+    void randomMove(int type);
+
+    // Feeds the cost deltas of random moves to the schedule's calibration
+    void sampleMoves(AnnealingSchedule& schedule, double cost);
+
+    void applyToBlocks(BStarArrayTree& solution);
+};
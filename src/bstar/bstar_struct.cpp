@@ -0,0 +1,164 @@
+#include "bstar_struct.hpp"
+
+#include <algorithm>
+
+void BStarArrayTree::reset(const std::vector<int>& order) {
+    int n = static_cast<int>(order.size());
+    parent.assign(n, NONE);
+    left.assign(n, NONE);
+    right.assign(n, NONE);
+    blockAt.assign(order.begin(), order.end());
+    nodeOf.assign(n, NONE);
+    rotated.assign(n, 0);
+    x.assign(n, 0);
+    y.assign(n, 0);
+    journal.clear();
+
+    // Heap-shaped start: node i has children 2i+1 (left) and 2i+2 (right)
+    for (int i = 0; i < n; i++) {
+        nodeOf[blockAt[i]] = i;
+        if (2 * i + 1 < n) {
+            left[i] = 2 * i + 1;
+            parent[2 * i + 1] = i;
+        }
+        if (2 * i + 2 < n) {
+            right[i] = 2 * i + 2;
+            parent[2 * i + 2] = i;
+        }
+    }
+    root = n > 0 ? 0 : NONE;
+    packedWidth = packedHeight = 0;
+}
+
+void BStarArrayTree::build(int root, const std::vector<int>& left, const std::vector<int>& right,
+                           const std::vector<int>& blockAt, const std::vector<int>& rotated) {
+    int n = static_cast<int>(blockAt.size());
+    this->root = root;
+    this->left = left;
+    this->right = right;
+    this->blockAt = blockAt;
+    this->rotated = rotated;
+    parent.assign(n, NONE);
+    nodeOf.assign(n, NONE);
+    for (int node = 0; node < n; node++) {
+        nodeOf[blockAt[node]] = node;
+        if (left[node] != NONE) parent[left[node]] = node;
+        if (right[node] != NONE) parent[right[node]] = node;
+    }
+    x.assign(n, 0);
+    y.assign(n, 0);
+    journal.clear();
+    packedWidth = packedHeight = 0;
+}
+
+void BStarArrayTree::rotate(int block) {
+    set(rotated[block], !rotated[block]);
+}
+
+void BStarArrayTree::swapBlocks(int blockA, int blockB) {
+    int nodeA = nodeOf[blockA];
+    int nodeB = nodeOf[blockB];
+    set(blockAt[nodeA], blockB);
+    set(blockAt[nodeB], blockA);
+    set(nodeOf[blockA], nodeB);
+    set(nodeOf[blockB], nodeA);
+}
+
+void BStarArrayTree::replaceChild(int node, int replacement) {
+    int p = parent[node];
+    if (p == NONE) {
+        set(root, replacement);
+    } else if (left[p] == node) {
+        set(left[p], replacement);
+    } else {
+        set(right[p], replacement);
+    }
+}
+
+bool BStarArrayTree::moveBlock(int block, int targetBlock, bool asLeftChild) {
+    if (block == targetBlock || size() < 2) return false;
+
+    // Bring the block down to a node with at most one child
+    int leaf = nodeOf[block];
+    while (left[leaf] != NONE && right[leaf] != NONE) {
+        leaf = left[leaf];
+    }
+    if (blockAt[leaf] != block) {
+        swapBlocks(block, blockAt[leaf]);
+    }
+
+    // Delete: splice the only child (if any) into the parent
+    int node = nodeOf[block];
+    int child = left[node] != NONE ? left[node] : right[node];
+    replaceChild(node, child);
+    if (child != NONE) set(parent[child], parent[node]);
+    set(parent[node], NONE);
+    set(left[node], NONE);
+    set(right[node], NONE);
+
+    // Insert: take the target's child slot and adopt its previous occupant
+    int target = nodeOf[targetBlock];
+    int& slot = asLeftChild ? left[target] : right[target];
+    int previous = slot;
+    set(slot, node);
+    set(parent[node], target);
+    if (previous != NONE) {
+        set(asLeftChild ? left[node] : right[node], previous);
+        set(parent[previous], node);
+    }
+    return true;
+}
+
+void BStarArrayTree::undo() {
+    for (auto it = journal.rbegin(); it != journal.rend(); ++it) {
+        *it->field = it->oldValue;
+    }
+    journal.clear();
+}
+
+void BStarArrayTree::pack(const std::vector<int>& widths, const std::vector<int>& heights) {
+    packedWidth = packedHeight = 0;
+    if (root == NONE) return;
+
+    auto width = [&](int b) { return rotated[b] ? heights[b] : widths[b]; };
+    auto height = [&](int b) { return rotated[b] ? widths[b] : heights[b]; };
+
+    // x follows from the tree alone; record the preorder and the contour
+    // breakpoints on the way
+    preorder.clear();
+    breakpoints.clear();
+    stack.clear();
+    stack.push_back(root);
+    x[blockAt[root]] = 0;
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        preorder.push_back(node);
+
+        int b = blockAt[node];
+        breakpoints.push_back(x[b]);
+        breakpoints.push_back(x[b] + width(b));
+
+        if (right[node] != NONE) {
+            x[blockAt[right[node]]] = x[b];
+            stack.push_back(right[node]);
+        }
+        if (left[node] != NONE) {
+            x[blockAt[left[node]]] = x[b] + width(b);
+            stack.push_back(left[node]);
+        }
+    }
+
+    // y: drop each block onto the contour in preorder
+    contour.reset(breakpoints);
+    for (int node : preorder) {
+        int b = blockAt[node];
+        int x1 = x[b];
+        int x2 = x1 + width(b);
+        y[b] = contour.maxHeight(x1, x2);
+        contour.assign(x1, x2, y[b] + height(b));
+
+        packedWidth = std::max(packedWidth, x2);
+        packedHeight = std::max(packedHeight, y[b] + height(b));
+    }
+}
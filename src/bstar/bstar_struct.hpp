@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../data_struct/Contour.hpp"
+#include <vector>
+
+/**
+ * @brief Array-based B*-tree over n blocks with journaled moves
+ *
+ * Tree positions (nodes) are indices into flat parent/left/right arrays and
+ * hold one block each, so moves touch a handful of integers and never
+ * allocate. A left child sits right of its parent, a right child on top of
+ * it at the same x. Packing fixes x from the tree, then visits the nodes in
+ * preorder and drops each block onto the shared segment-tree Contour, for
+ * O(n log n) per pack.
+ *
+ * Every change a move makes is recorded in a journal as (field, old value),
+ * so undo() restores the previous tree in time proportional to the move
+ * (at most a dozen fields) and commit() simply forgets the journal.
+ */
+class BStarArrayTree {
+public:
+    static constexpr int NONE = -1;
+
+    BStarArrayTree() : root(NONE), packedWidth(0), packedHeight(0) {}
+
+    /**
+     * Builds a balanced tree over blocks 0..n-1 in the given order, unrotated
+     */
+    void reset(const std::vector<int>& order);
+
+    /**
+     * Builds the given tree; node i holds blockAt[i]
+     *
+     * @param root Root node
+     * @param left Left child per node (NONE if absent)
+     * @param right Right child per node (NONE if absent)
+     * @param blockAt Block per node, a permutation of 0..n-1
+     * @param rotated Rotation flag per block
+     */
+    void build(int root, const std::vector<int>& left, const std::vector<int>& right,
+               const std::vector<int>& blockAt, const std::vector<int>& rotated);
+
+    int size() const { return static_cast<int>(blockAt.size()); }
+
+    // Tree structure, by node
+    int getRoot() const { return root; }
+    int getLeft(int node) const { return left[node]; }
+    int getRight(int node) const { return right[node]; }
+    int getBlockAt(int node) const { return blockAt[node]; }
+
+    /**
+     * Packs the blocks to the lower-left
+     *
+     * @param widths Unrotated block widths
+     * @param heights Unrotated block heights
+     */
+    void pack(const std::vector<int>& widths, const std::vector<int>& heights);
+
+    // Moves; each is recorded in the journal until commit() or undo()
+    void rotate(int block);
+    void swapBlocks(int blockA, int blockB);
+
+    /**
+     * Deletes the block's node and reinserts it as the given child of the
+     * target block's node; the child previously there moves under it
+     *
+     * Only leaves and single-child nodes are deleted (the child is spliced
+     * into the parent). A block on a node with two children is first swapped
+     * down the left spine to the first node with at most one child, so the
+     * move costs O(depth) in that case and O(1) otherwise. Every change goes
+     * through the journal, so undo() stays proportional to the change.
+     *
+     * @return False if the move was not possible (nothing was changed)
+     */
+    bool moveBlock(int block, int targetBlock, bool asLeftChild);
+
+    void commit() { journal.clear(); }
+    void undo();
+
+    bool isRotated(int block) const { return rotated[block] != 0; }
+
+    // Results of the last pack()
+    int getX(int block) const { return x[block]; }
+    int getY(int block) const { return y[block]; }
+    int getPackedWidth() const { return packedWidth; }
+    int getPackedHeight() const { return packedHeight; }
+
+private:
+    struct JournalEntry {
+        int* field;
+        int oldValue;
+    };
+
+    // Tree links by node
+    std::vector<int> parent;
+    std::vector<int> left;
+    std::vector<int> right;
+    int root;
+
+    std::vector<int> blockAt;   // Node -> block
+    std::vector<int> nodeOf;    // Block -> node
+    std::vector<int> rotated;   // By block
+
+    std::vector<JournalEntry> journal;
+
+    // Packing scratch and results (by block)
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<int> preorder;
+    std::vector<int> stack;
+    std::vector<int> breakpoints;
+    Contour contour;
+    int packedWidth;
+    int packedHeight;
+
+    void set(int& field, int value) {
+        journal.push_back({&field, field});
+        field = value;
+    }
+
+    /**
+     * Points the parent's link (or the root) at replacement instead of node
+     */
+    void replaceChild(int node, int replacement);
+};
@@ -14,7 +14,9 @@
 #include "Module.hpp"
 #include "SymmetryConstraint.hpp"
 #include "ASFBStarTree.hpp"
+#include "SymmetryKernels.hpp"
 #include "../Logger.hpp"
+#include "../Profiler.hpp"
 
 
 /**
@@ -22,44 +24,56 @@
  * This implementation optimizes for vertical stacking and minimal area
  */
 void ASFBStarTree::packBStarTree() {
-    // Clear the contour
-    clearContour();
-    
     Logger::log("Starting to pack ASF-B*-tree with vertical stacking optimization");
     
-    // Initialize node positions
-    std::unordered_map<BStarNode*, std::pair<int, int>> nodePositions;
+    std::vector<int>& xs = geometry.x;
+    std::vector<int>& ys = geometry.y;
+    const std::vector<int>& ws = geometry.w;
+    const std::vector<int>& hs = geometry.h;
     
-    // Use level-order traversal (BFS) to ensure parents are processed before children
-    std::queue<BStarNode*> bfsQueue;
+    // Use level-order traversal (BFS) to ensure parents are processed before children.
+    // X-coordinates only depend on the tree, so a first sweep fixes them and
+    // collects the breakpoints the contour is built over.
+    packQueue.clear();
+    contourBreakpoints.clear();
     if (root != nullptr) {
-        bfsQueue.push(root);
-        // Root is placed at (0,0)
-        nodePositions[root] = {0, 0};
+        packQueue.push_back(root);
+        xs[root->id] = 0;
+    }
+    
+    for (size_t head = 0; head < packQueue.size(); head++) {
+        BStarNode* node = packQueue[head];
+        int nodeX = xs[node->id];
         
-        // Update the module position
-        modules[root->moduleName]->setPosition(0, 0);
+        contourBreakpoints.push_back(nodeX);
+        contourBreakpoints.push_back(nodeX + ws[node->id]);
         
-        // Update the contour
-        updateContour(0, 0, modules[root->moduleName]->getWidth(), modules[root->moduleName]->getHeight());
-        Logger::log("Placed root " + root->moduleName + " at (0, 0)");
+        if (node->left) {
+            xs[node->left->id] = nodeX + ws[node->id];
+            packQueue.push_back(node->left);
+        }
+        if (node->right) {
+            xs[node->right->id] = nodeX;
+            packQueue.push_back(node->right);
+        }
     }
     
+    contour.reset(contourBreakpoints);
+    
     try {
-        while (!bfsQueue.empty()) {
-            BStarNode* node = bfsQueue.front();
-            bfsQueue.pop();
-            
-            // Get current node position
-            int nodeX = nodePositions[node].first;
-            int nodeY = nodePositions[node].second;
-            
-            Logger::log("Processing node: " + node->moduleName + " at position (" + 
-                        std::to_string(nodeX) + ", " + std::to_string(nodeY) + ")");
+        if (root != nullptr) {
+            // Root is placed at (0,0)
+            ys[root->id] = 0;
+            contour.raise(0, ws[root->id], hs[root->id]);
+        }
+        
+        for (BStarNode* node : packQueue) {
+            int nodeY = ys[node->id];
             
             // Process left child (placed to the right of current node)
             if (node->left) {
-                int leftX = nodeX + modules[node->moduleName]->getWidth();
+                int child = node->left->id;
+                int leftX = xs[child];
                 
                 // For vertical stacking, try to minimize x-coordinate
                 // by checking if the module can be placed at the current contour height
@@ -67,54 +81,26 @@ void ASFBStarTree::packBStarTree() {
                 
                 // Try to keep y-coordinate the same as parent if possible
                 // to create tighter packing and better symmetry islands
-                if (!hasContourOverlap(leftX, nodeY, 
-                                       modules[node->left->moduleName]->getWidth(), 
-                                       modules[node->left->moduleName]->getHeight())) {
+                if (!hasContourOverlap(leftX, nodeY, ws[child], hs[child])) {
                     leftY = nodeY; // Maintain same y-coordinate as parent
                 }
                 
-                // Store position of left child
-                nodePositions[node->left] = {leftX, leftY};
-                
-                // Update module position
-                modules[node->left->moduleName]->setPosition(leftX, leftY);
-                
-                // Update the contour
-                updateContour(leftX, leftY, 
-                              modules[node->left->moduleName]->getWidth(), 
-                              modules[node->left->moduleName]->getHeight());
-                
-                Logger::log("Placed left child " + node->left->moduleName + 
-                            " at (" + std::to_string(leftX) + ", " + std::to_string(leftY) + ")");
-                
-                // Add to queue for further processing
-                bfsQueue.push(node->left);
+                ys[child] = leftY;
+                contour.raise(leftX, leftX + ws[child], leftY + hs[child]);
             }
             
             // Process right child (placed at same x, above current node)
             if (node->right) {
-                int rightX = nodeX;
-                int rightY = nodeY + modules[node->moduleName]->getHeight();
-                
-                // Store position of right child
-                nodePositions[node->right] = {rightX, rightY};
+                int child = node->right->id;
+                int rightY = nodeY + hs[node->id];
                 
-                // Update module position
-                modules[node->right->moduleName]->setPosition(rightX, rightY);
-                
-                // Update the contour
-                updateContour(rightX, rightY, 
-                              modules[node->right->moduleName]->getWidth(), 
-                              modules[node->right->moduleName]->getHeight());
-                
-                Logger::log("Placed right child " + node->right->moduleName + 
-                            " at (" + std::to_string(rightX) + ", " + std::to_string(rightY) + ")");
-                
-                // Add to queue for further processing
-                bfsQueue.push(node->right);
+                ys[child] = rightY;
+                contour.raise(xs[child], xs[child] + ws[child], rightY + hs[child]);
             }
         }
         
+        Logger::log("Placed " + std::to_string(packQueue.size()) + " representative modules");
+        
         // Apply compaction to further minimize area
         compactPlacement();
         
@@ -126,90 +112,68 @@ void ASFBStarTree::packBStarTree() {
 
 
 /**
- * Updates the contour after placing a module
- * 
- * @param x X-coordinate of the module
- * @param y Y-coordinate of the module
- * @param width Width of the module
- * @param height Height of the module
+ * Rotates self-symmetric modules so their lengths along the symmetry
+ * direction share one parity, using as few rotations as possible
  */
-void ASFBStarTree::updateContour(int x, int y, int width, int height) {
-    int right = x + width;
-    int top = y + height;
-    
-    // Create a new contour point if contour is empty
-    if (contourHead == nullptr) {
-        contourHead = new ContourPoint(x, top);
-        contourHead->next = new ContourPoint(right, 0);
-        return;
-    }
+void ASFBStarTree::alignSelfSymmetricParity() {
+    exactSymmetryPossible = true;
+    if (selfSymIds.empty()) return;
     
-    // Find the position to insert or update
-    ContourPoint* curr = contourHead;
-    ContourPoint* prev = nullptr;
+    bool vertical = symmetryGroup->getType() == SymmetryType::VERTICAL;
+    const std::vector<int>& len = vertical ? geometry.w : geometry.h;
+    const std::vector<int>& crossLen = vertical ? geometry.h : geometry.w;
     
-    // Skip points to the left of the module
-    while (curr != nullptr && curr->x < x) {
-        prev = curr;
-        curr = curr->next;
+    int bestParity = -1;
+    int bestRotations = std::numeric_limits<int>::max();
+    for (int parity = 0; parity < 2; parity++) {
+        int rotations = 0;
+        for (int id : selfSymIds) {
+            if ((len[id] & 1) == parity) continue;
+            if ((crossLen[id] & 1) != parity) {
+                rotations = -1;
+                break;
+            }
+            rotations++;
+        }
+        if (rotations >= 0 && rotations < bestRotations) {
+            bestParity = parity;
+            bestRotations = rotations;
+        }
     }
     
-    // Handle case where we need to insert a point at x
-    if (curr == nullptr || curr->x > x) {
-        // Create a new point at the left edge of the module
-        ContourPoint* newPoint = new ContourPoint(x, top);
-        
-        // Link the new point
-        if (prev) {
-            prev->next = newPoint;
-        } else {
-            contourHead = newPoint;
-        }
-        newPoint->next = curr;
-        
-        // Update for next operations
-        prev = newPoint;
-    } else if (curr->x == x) {
-        // Update existing point at x
-        curr->height = std::max(curr->height, top);
-        prev = curr;
-        curr = curr->next;
+    if (bestParity < 0) {
+        exactSymmetryPossible = false;
+        Logger::log("ERROR: No rotation gives the self-symmetric modules of " + symmetryGroup->getName() +
+                   " lengths of one parity, they are centered to within half a unit");
+        return;
     }
     
-    // Process or remove intermediate points up to right edge
-    while (curr != nullptr && curr->x < right) {
-        if (curr->height <= top) {
-            // This point is below or at our new contour height, so remove it
-            ContourPoint* temp = curr;
-            curr = curr->next;
-            delete temp;
-            
-            if (prev) {
-                prev->next = curr;
-            } else {
-                contourHead = curr;
-            }
-        } else {
-            // This point is above our new contour, keep it
-            prev = curr;
-            curr = curr->next;
+    for (int id : selfSymIds) {
+        if ((len[id] & 1) != bestParity) {
+            setGeometryRotation(id, !geometry.rotated[id]);
         }
     }
+}
+
+/**
+ * Stacks self-symmetric modules that share rows on top of each other
+ */
+void ASFBStarTree::separateSelfSymmetricModules() {
+    if (selfSymIds.size() < 2) return;
     
-    // Handle the right edge point
-    if (curr == nullptr || curr->x > right) {
-        // Add a new point at the right edge
-        ContourPoint* newPoint = new ContourPoint(right, prev ? prev->height : 0);
-        newPoint->next = curr;
-        
-        if (prev) {
-            prev->next = newPoint;
-        } else {
-            contourHead = newPoint;
+    bool vertical = symmetryGroup->getType() == SymmetryType::VERTICAL;
+    std::vector<int>& cross = vertical ? geometry.y : geometry.x;
+    const std::vector<int>& crossLen = vertical ? geometry.h : geometry.w;
+    
+    std::stable_sort(selfSymIds.begin(), selfSymIds.end(),
+                     [&cross](int a, int b) { return cross[a] < cross[b]; });
+    
+    int top = std::numeric_limits<int>::min();
+    for (int id : selfSymIds) {
+        if (cross[id] < top) {
+            cross[id] = top;
         }
-    } else if (curr->x == right) {
-        // Update existing point at the right edge
-        curr->height = std::max(curr->height, prev ? prev->height : 0);
+        top = cross[id] + crossLen[id];
     }
 }
 
@@ -220,154 +184,133 @@ void ASFBStarTree::updateContour(int x, int y, int width, int height) {
 void ASFBStarTree::calculateSymmetryAxisPosition() {
     Logger::log("Calculating symmetry axis position with positive coordinate guarantee");
     
-    if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
-        // For vertical symmetry, find the optimal axis position
-        if (!repToPairMap.empty()) {
-            // Find the rightmost representative module to determine minimum axis position
-            double maxRepRightEdge = std::numeric_limits<double>::min();
-            double minSymLeftEdge = std::numeric_limits<double>::max();
-            
-            // First pass: find the bounds of representative modules
-            for (const auto& pair : repToPairMap) {
-                const std::string& repName = pair.first;
-                std::shared_ptr<Module> repModule = modules[repName];
-                
-                double repRightEdge = repModule->getX() + repModule->getWidth();
-                maxRepRightEdge = std::max(maxRepRightEdge, repRightEdge);
-            }
-            
-            // Second pass: calculate minimum axis position needed for positive coordinates
-            double minAxisPosition = maxRepRightEdge; // Start with rightmost rep edge
-            
-            for (const auto& pair : repToPairMap) {
-                const std::string& repName = pair.first;
-                const std::string& symName = pair.second;
-                
-                std::shared_ptr<Module> repModule = modules[repName];
-                std::shared_ptr<Module> symModule = modules[symName];
-                
-                double repCenterX = repModule->getX() + repModule->getWidth() / 2.0;
-                
-                // For symmetric module to have positive coordinates:
-                // symCenterX = 2 * axis - repCenterX >= symWidth/2
-                // Therefore: axis >= (repCenterX + symWidth/2) / 2
-                double minAxisForThisPair = (repCenterX + symModule->getWidth() / 2.0) / 2.0;
-                
-                // But we also need: symLeftEdge = symCenterX - symWidth/2 >= 0
-                // symCenterX = 2 * axis - repCenterX
-                // So: 2 * axis - repCenterX - symWidth/2 >= 0
-                // Therefore: axis >= (repCenterX + symWidth/2) / 2
-                double minAxisForPositiveCoords = (repCenterX + symModule->getWidth() / 2.0) / 2.0;
-                
-                minAxisPosition = std::max(minAxisPosition, minAxisForPositiveCoords);
-            }
-            
-            // Add a small buffer to ensure positive coordinates
-            symmetryAxisPosition = minAxisPosition + 1.0;
-            
-            Logger::log("Calculated axis position to ensure positive coordinates:");
-            Logger::log("  Max rep right edge: " + std::to_string(maxRepRightEdge));
-            Logger::log("  Min axis position needed: " + std::to_string(minAxisPosition));
-            Logger::log("  Final axis X: " + std::to_string(symmetryAxisPosition));
-            
-        } else if (!selfSymmetricModules.empty()) {
-            // If no symmetry pairs, position axis based on representative modules layout
-            int minX = std::numeric_limits<int>::max();
-            int maxX = std::numeric_limits<int>::min();
-            
-            for (const auto& pair : representativeModules) {
-                const auto& module = modules[pair.first];
-                minX = std::min(minX, module->getX());
-                maxX = std::max(maxX, module->getX() + module->getWidth());
-            }
-            
-            // Find the widest self-symmetric module to determine spacing
-            int maxSelfSymWidth = 0;
-            for (const auto& moduleName : selfSymmetricModules) {
-                auto module = modules[moduleName];
-                maxSelfSymWidth = std::max(maxSelfSymWidth, module->getWidth());
-            }
-            
-            // Position axis to allow symmetric placement
-            symmetryAxisPosition = maxX + (maxSelfSymWidth / 2.0) + 1;
-            
-            Logger::log("Calculated axis from layout bounds:");
-            Logger::log("  Layout max X: " + std::to_string(maxX));
-            Logger::log("  Max self-sym width: " + std::to_string(maxSelfSymWidth));
-            Logger::log("  Axis X: " + std::to_string(symmetryAxisPosition));
+    // Along the symmetry direction VERTICAL works on (x, w), HORIZONTAL on (y, h)
+    bool vertical = symmetryGroup->getType() == SymmetryType::VERTICAL;
+    const std::vector<int>& pos = vertical ? geometry.x : geometry.y;
+    const std::vector<int>& len = vertical ? geometry.w : geometry.h;
+    const std::vector<int>& cross = vertical ? geometry.y : geometry.x;
+    const std::vector<int>& crossLen = vertical ? geometry.h : geometry.w;
+    
+    // The axis is kept in half-units so mirrored positions stay integral
+    if (!pairRepIds.empty()) {
+        // Find the outermost representative edge to determine minimum axis position
+        int maxRepEdge = 0;
+        for (int rep : pairRepIds) {
+            maxRepEdge = std::max(maxRepEdge, pos[rep] + len[rep]);
         }
-    } else {
-        // For horizontal symmetry
-        if (!repToPairMap.empty()) {
-            // Find the bottommost representative module to determine minimum axis position
-            double maxRepBottomEdge = std::numeric_limits<double>::min();
-            
-            // First pass: find the bounds of representative modules
-            for (const auto& pair : repToPairMap) {
-                const std::string& repName = pair.first;
-                std::shared_ptr<Module> repModule = modules[repName];
-                
-                double repBottomEdge = repModule->getY() + repModule->getHeight();
-                maxRepBottomEdge = std::max(maxRepBottomEdge, repBottomEdge);
-            }
-            
-            // Second pass: calculate minimum axis position needed for positive coordinates
-            double minAxisPosition = maxRepBottomEdge; // Start with bottommost rep edge
-            
-            for (const auto& pair : repToPairMap) {
-                const std::string& repName = pair.first;
-                const std::string& symName = pair.second;
-                
-                std::shared_ptr<Module> repModule = modules[repName];
-                std::shared_ptr<Module> symModule = modules[symName];
-                
-                double repCenterY = repModule->getY() + repModule->getHeight() / 2.0;
-                
-                // For symmetric module to have positive coordinates:
-                // symCenterY = 2 * axis - repCenterY >= symHeight/2
-                // Therefore: axis >= (repCenterY + symHeight/2) / 2
-                double minAxisForPositiveCoords = (repCenterY + symModule->getHeight() / 2.0) / 2.0;
-                
-                minAxisPosition = std::max(minAxisPosition, minAxisForPositiveCoords);
-            }
-            
-            // Add a small buffer to ensure positive coordinates
-            symmetryAxisPosition = minAxisPosition + 1.0;
-            
-            Logger::log("Calculated axis position to ensure positive coordinates:");
-            Logger::log("  Max rep bottom edge: " + std::to_string(maxRepBottomEdge));
-            Logger::log("  Min axis position needed: " + std::to_string(minAxisPosition));
-            Logger::log("  Final axis Y: " + std::to_string(symmetryAxisPosition));
-            
-        } else if (!selfSymmetricModules.empty()) {
-            int minY = std::numeric_limits<int>::max();
-            int maxY = std::numeric_limits<int>::min();
-            
-            for (const auto& pair : representativeModules) {
-                const auto& module = modules[pair.first];
-                minY = std::min(minY, module->getY());
-                maxY = std::max(maxY, module->getY() + module->getHeight());
-            }
-            
-            int maxSelfSymHeight = 0;
-            for (const auto& moduleName : selfSymmetricModules) {
-                auto module = modules[moduleName];
-                maxSelfSymHeight = std::max(maxSelfSymHeight, module->getHeight());
+        
+        // Calculate minimum axis position needed for positive coordinates
+        int minAxis2 = 2 * maxRepEdge;
+        
+        for (size_t i = 0; i < pairRepIds.size(); i++) {
+            int rep = pairRepIds[i];
+            int sym = pairSymIds[i];
+            
+            // For symmetric module to have positive coordinates:
+            // symCenter = 2 * axis - repCenter >= symLength/2
+            // Therefore: 2 * axis >= (2 * repPos + repLength + symLength) / 2
+            minAxis2 = std::max(minAxis2, (2 * pos[rep] + len[rep] + len[sym] + 1) / 2);
+        }
+        
+        // Add a small buffer to ensure positive coordinates
+        symmetryAxis2 = minAxis2 + 2;
+        
+        Logger::log("Calculated axis position to ensure positive coordinates:");
+        Logger::log("  Max rep edge: " + std::to_string(maxRepEdge));
+        Logger::log("  Min axis position needed: " + std::to_string(minAxis2 / 2.0));
+        
+    } else if (!selfSymIds.empty()) {
+        // If no symmetry pairs, position axis based on representative modules layout
+        int maxEdge = std::numeric_limits<int>::min();
+        for (int rep : repIds) {
+            maxEdge = std::max(maxEdge, pos[rep] + len[rep]);
+        }
+        
+        // Find the largest self-symmetric module to determine spacing
+        int maxSelfSymLength = 0;
+        for (int id : selfSymIds) {
+            maxSelfSymLength = std::max(maxSelfSymLength, len[id]);
+        }
+        
+        // Position axis to allow symmetric placement: maxEdge + maxLength / 2 + 1
+        symmetryAxis2 = 2 * maxEdge + maxSelfSymLength + 2;
+        
+        Logger::log("Calculated axis from layout bounds:");
+        Logger::log("  Layout max edge: " + std::to_string(maxEdge));
+        Logger::log("  Max self-sym extent: " + std::to_string(maxSelfSymLength));
+    }
+    
+    // Centered self-symmetric modules straddle the axis, so each must clear
+    // the outer edge of every representative sharing its rows
+    for (int self : selfSymIds) {
+        symmetryAxis2 = std::max(symmetryAxis2, len[self]);
+        for (int rep : pairRepIds) {
+            bool crossOverlap = cross[rep] < cross[self] + crossLen[self] &&
+                                cross[self] < cross[rep] + crossLen[rep];
+            if (crossOverlap) {
+                symmetryAxis2 = std::max(symmetryAxis2, 2 * (pos[rep] + len[rep]) + len[self]);
             }
-            
-            symmetryAxisPosition = maxY + (maxSelfSymHeight / 2.0) + 1;
-            
-            Logger::log("Calculated axis from layout bounds:");
-            Logger::log("  Layout max Y: " + std::to_string(maxY));
-            Logger::log("  Max self-sym height: " + std::to_string(maxSelfSymHeight));
-            Logger::log("  Axis Y: " + std::to_string(symmetryAxisPosition));
         }
     }
     
+    // A self-symmetric module is centered exactly only if its length has the
+    // same parity as symmetryAxis2 (alignSelfSymmetricParity made them agree)
+    if (exactSymmetryPossible && !selfSymIds.empty() && (symmetryAxis2 & 1) != (len[selfSymIds[0]] & 1)) {
+        // Moving the axis outwards keeps all coordinates non-negative
+        symmetryAxis2++;
+    }
+    
+    symmetryAxisPosition = symmetryAxis2 / 2.0;
+    Logger::log(std::string("  Final axis ") + (vertical ? "X: " : "Y: ") + std::to_string(symmetryAxisPosition));
+    
     symmetryGroup->setAxisPosition(symmetryAxisPosition);
 }
 
-// Replace updateSymmetricModulePositions() in ASFBStarTree.cpp
+/**
+ * Gathers the current pair and self-symmetric geometry into contiguous lanes
+ */
+void ASFBStarTree::gatherPairLanes() const {
+    bool vertical = symmetryGroup->getType() == SymmetryType::VERTICAL;
+    const std::vector<int>& pos = vertical ? geometry.x : geometry.y;
+    const std::vector<int>& len = vertical ? geometry.w : geometry.h;
+    const std::vector<int>& cross = vertical ? geometry.y : geometry.x;
+    const std::vector<int>& crossLen = vertical ? geometry.h : geometry.w;
+    
+    size_t n = pairRepIds.size();
+    PairLanes& lanes = pairLanes;
+    lanes.repPos.resize(n);
+    lanes.repLen.resize(n);
+    lanes.repCross.resize(n);
+    lanes.repCrossLen.resize(n);
+    lanes.symPos.resize(n);
+    lanes.symLen.resize(n);
+    lanes.symCross.resize(n);
+    lanes.symCrossLen.resize(n);
+    
+    for (size_t i = 0; i < n; i++) {
+        int rep = pairRepIds[i];
+        int sym = pairSymIds[i];
+        lanes.repPos[i] = pos[rep];
+        lanes.repLen[i] = len[rep];
+        lanes.repCross[i] = cross[rep];
+        lanes.repCrossLen[i] = crossLen[rep];
+        lanes.symPos[i] = pos[sym];
+        lanes.symLen[i] = len[sym];
+        lanes.symCross[i] = cross[sym];
+        lanes.symCrossLen[i] = crossLen[sym];
+    }
+    
+    lanes.selfPos.resize(selfSymIds.size());
+    lanes.selfLen.resize(selfSymIds.size());
+    for (size_t i = 0; i < selfSymIds.size(); i++) {
+        lanes.selfPos[i] = pos[selfSymIds[i]];
+        lanes.selfLen[i] = len[selfSymIds[i]];
+    }
+}
+
+/**
+ * Updates the positions of symmetric modules based on their representatives
+ */
 void ASFBStarTree::updateSymmetricModulePositions() {
     // Make sure the symmetry axis is set
     if (symmetryAxisPosition < 0) {
@@ -376,188 +319,58 @@ void ASFBStarTree::updateSymmetricModulePositions() {
     
     Logger::log("Updating symmetric module positions with axis at " + std::to_string(symmetryAxisPosition));
     
-    // Update positions for symmetry pairs with dimension matching
-    for (const auto& pair : repToPairMap) {
-        const std::string& repName = pair.first;
-        const std::string& symName = pair.second;
-        
-        std::shared_ptr<Module> repModule = modules[repName];
-        std::shared_ptr<Module> symModule = modules[symName];
+    const std::vector<int>& ws = geometry.w;
+    const std::vector<int>& hs = geometry.h;
+    
+    // Ensure dimensions match between each symmetry pair
+    for (size_t i = 0; i < pairRepIds.size(); i++) {
+        int rep = pairRepIds[i];
+        int sym = pairSymIds[i];
         
-        // Ensure dimensions match between symmetry pair
         bool needsRotation = false;
-        if (repModule->getWidth() != symModule->getWidth() || 
-            repModule->getHeight() != symModule->getHeight()) {
-            
+        if (ws[rep] != ws[sym] || hs[rep] != hs[sym]) {
             // Check if rotating the symmetric module makes dimensions match
-            if (repModule->getWidth() == symModule->getHeight() && 
-                repModule->getHeight() == symModule->getWidth()) {
-                symModule->rotate();
+            if (ws[rep] == hs[sym] && hs[rep] == ws[sym]) {
+                setGeometryRotation(sym, !geometry.rotated[sym]);
                 needsRotation = true;
-                Logger::log("Rotated " + symName + " to match dimensions of " + repName);
+                Logger::log("Rotated " + moduleName(geometry.modules[sym]) + " to match dimensions of " + moduleName(geometry.modules[rep]));
             } else {
-                Logger::log("WARNING: Dimension mismatch between " + repName + " and " + symName + 
-                           " cannot be resolved by rotation");
+                Logger::log("WARNING: Dimension mismatch between " + moduleName(geometry.modules[rep]) + " and " + 
+                           moduleName(geometry.modules[sym]) + " cannot be resolved by rotation");
             }
         }
         
-        if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
-            // For vertical symmetry: x_center1 + x_center2 = 2 × axis_x, y1 = y2
-            
-            // Calculate representative module center
-            double repCenterX = repModule->getX() + repModule->getWidth() / 2.0;
-            
-            // Calculate symmetric module center position
-            double symCenterX = 2.0 * symmetryAxisPosition - repCenterX;
-            
-            // Calculate symmetric module position (top-left corner)
-            double symX = symCenterX - symModule->getWidth() / 2.0;
-            int symXInt = static_cast<int>(std::round(symX));
-            int symY = repModule->getY(); // Same Y for vertical symmetry
-            
-            symModule->setPosition(symXInt, symY);
-            
-            // Verify the result
-            double actualSymCenterX = symXInt + symModule->getWidth() / 2.0;
-            double actualSum = repCenterX + actualSymCenterX;
-            double expectedSum = 2.0 * symmetryAxisPosition;
-            double error = std::abs(actualSum - expectedSum);
-            
-            Logger::log("Vertical symmetry pair (" + repName + ", " + symName + "):");
-            Logger::log("  Rep center X: " + std::to_string(repCenterX));
-            Logger::log("  Target sym center X: " + std::to_string(symCenterX));
-            Logger::log("  Actual sym center X: " + std::to_string(actualSymCenterX));
-            Logger::log("  Expected sum: " + std::to_string(expectedSum));
-            Logger::log("  Actual sum: " + std::to_string(actualSum));
-            Logger::log("  Error: " + std::to_string(error));
-            
-        } else {
-            // For horizontal symmetry: x1 = x2, y_center1 + y_center2 = 2 × axis_y
-            
-            double repCenterY = repModule->getY() + repModule->getHeight() / 2.0;
-            double symCenterY = 2.0 * symmetryAxisPosition - repCenterY;
-            
-            double symY = symCenterY - symModule->getHeight() / 2.0;
-            int symYInt = static_cast<int>(std::round(symY));
-            int symX = repModule->getX(); // Same X for horizontal symmetry
-            
-            symModule->setPosition(symX, symYInt);
-            
-            // Verify the result
-            double actualSymCenterY = symYInt + symModule->getHeight() / 2.0;
-            double actualSum = repCenterY + actualSymCenterY;
-            double expectedSum = 2.0 * symmetryAxisPosition;
-            double error = std::abs(actualSum - expectedSum);
-            
-            Logger::log("Horizontal symmetry pair (" + repName + ", " + symName + "):");
-            Logger::log("  Rep center Y: " + std::to_string(repCenterY));
-            Logger::log("  Target sym center Y: " + std::to_string(symCenterY));
-            Logger::log("  Actual sym center Y: " + std::to_string(actualSymCenterY));
-            Logger::log("  Expected sum: " + std::to_string(expectedSum));
-            Logger::log("  Actual sum: " + std::to_string(actualSum));
-            Logger::log("  Error: " + std::to_string(error));
-        }
-        
         // Ensure rotation status matches if dimensions were originally the same
         if (!needsRotation) {
-            symModule->setRotation(repModule->getRotated());
+            setGeometryRotation(sym, geometry.rotated[rep] != 0);
         }
     }
     
-    // Handle self-symmetric modules with precise centering
-    for (const auto& moduleName : selfSymmetricModules) {
-        auto module = modules[moduleName];
-        
-        if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
-            // For vertical symmetry, center the module exactly on the axis
-            int moduleWidth = module->getWidth();
-            
-            // Calculate the exact position needed to center the module on the axis
-            // axis_position = module_left + module_width/2
-            // Therefore: module_left = axis_position - module_width/2
-            double exactLeft = symmetryAxisPosition - (moduleWidth / 2.0);
-            
-            // Use proper rounding to get the closest integer position
-            int moduleX = static_cast<int>(std::round(exactLeft));
-            
-            // Calculate the resulting center and check if we can do better
-            double resultingCenterX = moduleX + (moduleWidth / 2.0);
-            double centerError = std::abs(resultingCenterX - symmetryAxisPosition);
-            
-            // If there's still significant error, try the adjacent positions
-            if (centerError > 0.25) { // More strict tolerance
-                int altX1 = moduleX - 1;
-                int altX2 = moduleX + 1;
-                
-                double altCenter1 = altX1 + (moduleWidth / 2.0);
-                double altCenter2 = altX2 + (moduleWidth / 2.0);
-                
-                double altError1 = std::abs(altCenter1 - symmetryAxisPosition);
-                double altError2 = std::abs(altCenter2 - symmetryAxisPosition);
-                
-                if (altError1 < centerError && altError1 < altError2) {
-                    moduleX = altX1;
-                    resultingCenterX = altCenter1;
-                    centerError = altError1;
-                } else if (altError2 < centerError) {
-                    moduleX = altX2;
-                    resultingCenterX = altCenter2;
-                    centerError = altError2;
-                }
-            }
-            
-            module->setPosition(moduleX, module->getY());
-            
-            Logger::log("Self-symmetric module " + moduleName + " (vertical):");
-            Logger::log("  Target axis X: " + std::to_string(symmetryAxisPosition));
-            Logger::log("  Module width: " + std::to_string(moduleWidth));
-            Logger::log("  Calculated exact left: " + std::to_string(exactLeft));
-            Logger::log("  Final position X: " + std::to_string(moduleX));
-            Logger::log("  Resulting center X: " + std::to_string(resultingCenterX));
-            Logger::log("  Center error: " + std::to_string(centerError));
-            
-        } else {
-            // For horizontal symmetry, center the module exactly on the axis
-            int moduleHeight = module->getHeight();
-            
-            double exactTop = symmetryAxisPosition - (moduleHeight / 2.0);
-            int moduleY = static_cast<int>(std::round(exactTop));
-            
-            double resultingCenterY = moduleY + (moduleHeight / 2.0);
-            double centerError = std::abs(resultingCenterY - symmetryAxisPosition);
-            
-            if (centerError > 0.25) {
-                int altY1 = moduleY - 1;
-                int altY2 = moduleY + 1;
-                
-                double altCenter1 = altY1 + (moduleHeight / 2.0);
-                double altCenter2 = altY2 + (moduleHeight / 2.0);
-                
-                double altError1 = std::abs(altCenter1 - symmetryAxisPosition);
-                double altError2 = std::abs(altCenter2 - symmetryAxisPosition);
-                
-                if (altError1 < centerError && altError1 < altError2) {
-                    moduleY = altY1;
-                    resultingCenterY = altCenter1;
-                    centerError = altError1;
-                } else if (altError2 < centerError) {
-                    moduleY = altY2;
-                    resultingCenterY = altCenter2;
-                    centerError = altError2;
-                }
-            }
-            
-            module->setPosition(module->getX(), moduleY);
-            
-            Logger::log("Self-symmetric module " + moduleName + " (horizontal):");
-            Logger::log("  Target axis Y: " + std::to_string(symmetryAxisPosition));
-            Logger::log("  Module height: " + std::to_string(moduleHeight));
-            Logger::log("  Calculated exact top: " + std::to_string(exactTop));
-            Logger::log("  Final position Y: " + std::to_string(moduleY));
-            Logger::log("  Resulting center Y: " + std::to_string(resultingCenterY));
-            Logger::log("  Center error: " + std::to_string(centerError));
-        }
+    // Mirror all pairs and center all self-symmetric modules in one pass each
+    gatherPairLanes();
+    PairLanes& lanes = pairLanes;
+    
+    SymmetryKernels::mirrorPairs(pairRepIds.size(), symmetryAxis2,
+                                 lanes.repPos.data(), lanes.repLen.data(), lanes.repCross.data(),
+                                 lanes.symLen.data(), lanes.symPos.data(), lanes.symCross.data());
+    SymmetryKernels::centerSelfSymmetric(selfSymIds.size(), symmetryAxis2,
+                                         lanes.selfLen.data(), lanes.selfPos.data());
+    
+    // Scatter the results back into the island geometry
+    bool vertical = symmetryGroup->getType() == SymmetryType::VERTICAL;
+    std::vector<int>& pos = vertical ? geometry.x : geometry.y;
+    std::vector<int>& cross = vertical ? geometry.y : geometry.x;
+    
+    for (size_t i = 0; i < pairSymIds.size(); i++) {
+        pos[pairSymIds[i]] = lanes.symPos[i];
+        cross[pairSymIds[i]] = lanes.symCross[i];
+    }
+    for (size_t i = 0; i < selfSymIds.size(); i++) {
+        pos[selfSymIds[i]] = lanes.selfPos[i];
     }
+    
+    Logger::log("Mirrored " + std::to_string(pairRepIds.size()) + " symmetry pairs and centered " + 
+               std::to_string(selfSymIds.size()) + " self-symmetric modules");
 }
 
 
@@ -574,20 +387,20 @@ void ASFBStarTree::buildInitialBStarTree() {
     root = nullptr;
     
     // Get all representative modules
-    std::vector<std::string> repModuleNames;
+    std::vector<ModuleId> repModules;
     for (const auto& pair : representativeModules) {
-        repModuleNames.push_back(pair.first);
+        repModules.push_back(pair.first);
     }
     
-    Logger::log("Total representative modules: " + std::to_string(repModuleNames.size()));
+    Logger::log("Total representative modules: " + std::to_string(repModules.size()));
     
     // Separate self-symmetric and non-self-symmetric modules
-    std::vector<std::string> nonSelfSymModules;
-    std::vector<std::string> selfSymModules = selfSymmetricModules;
+    std::vector<ModuleId> nonSelfSymModules;
+    std::vector<ModuleId> selfSymModules = selfSymmetricModules;
     
-    for (const auto& name : repModuleNames) {
-        if (!isSelfSymmetric(name)) {
-            nonSelfSymModules.push_back(name);
+    for (ModuleId module : repModules) {
+        if (!isSelfSymmetric(module)) {
+            nonSelfSymModules.push_back(module);
         }
     }
     
@@ -598,59 +411,59 @@ void ASFBStarTree::buildInitialBStarTree() {
     if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
         // For vertical symmetry, sort by height first to stack efficiently
         std::sort(nonSelfSymModules.begin(), nonSelfSymModules.end(),
-                 [this](const std::string& a, const std::string& b) {
+                 [this](ModuleId a, ModuleId b) {
                      return modules[a]->getHeight() < modules[b]->getHeight();
                  });
     } else {
         // For horizontal symmetry, sort by width first to stack efficiently
         std::sort(nonSelfSymModules.begin(), nonSelfSymModules.end(),
-                 [this](const std::string& a, const std::string& b) {
+                 [this](ModuleId a, ModuleId b) {
                      return modules[a]->getWidth() < modules[b]->getWidth();
                  });
     }
     
     // Create nodes for all modules
-    std::unordered_map<std::string, BStarNode*> nodeMap;
-    for (const auto& name : repModuleNames) {
-        nodeMap[name] = new BStarNode(name);
-        Logger::log("Created node for module: " + name);
+    std::unordered_map<ModuleId, BStarNode*> nodeMap;
+    for (ModuleId module : repModules) {
+        nodeMap[module] = new BStarNode(module, localIds[module]);
+        Logger::log("Created node for module: " + moduleName(module));
     }
     
     // Build a tree that arranges modules for vertical stacking
-    if (!repModuleNames.empty()) {
-        std::string rootName;
+    if (!repModules.empty()) {
+        ModuleId rootModule = SymbolTable::NONE;
         
         // For vertical symmetry, we want to start with a module with small width
         // For horizontal symmetry, we want to start with a module with small height
         if (!nonSelfSymModules.empty()) {
-            rootName = nonSelfSymModules.front();
+            rootModule = nonSelfSymModules.front();
             nonSelfSymModules.erase(nonSelfSymModules.begin());
-            Logger::log("Using non-self-symmetric module as root: " + rootName);
+            Logger::log("Using non-self-symmetric module as root: " + moduleName(rootModule));
         } else if (!selfSymModules.empty()) {
-            rootName = selfSymModules.front();
+            rootModule = selfSymModules.front();
             selfSymModules.erase(selfSymModules.begin());
-            Logger::log("Using self-symmetric module as root: " + rootName);
+            Logger::log("Using self-symmetric module as root: " + moduleName(rootModule));
         } else {
             Logger::log("ERROR: No modules to place in symmetry group");
             throw std::runtime_error("No modules to place in symmetry group");
         }
         
-        root = nodeMap[rootName];
+        root = nodeMap[rootModule];
         
         // Create a chain of modules to stack them vertically
         BStarNode* currentNode = root;
         
         // First place all self-symmetric modules on the proper boundary
-        for (const auto& name : selfSymModules) {
+        for (ModuleId module : selfSymModules) {
             if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
                 // For vertical symmetry, self-symmetric modules on rightmost branch
-                Logger::log("Placed self-symmetric module " + name + " as right child of " + currentNode->moduleName);
-                currentNode->right = nodeMap[name];
+                Logger::log("Placed self-symmetric module " + moduleName(module) + " as right child of " + moduleName(currentNode->module));
+                currentNode->right = nodeMap[module];
                 currentNode = currentNode->right;
             } else {
                 // For horizontal symmetry, self-symmetric modules on leftmost branch
-                Logger::log("Placed self-symmetric module " + name + " as left child of " + currentNode->moduleName);
-                currentNode->left = nodeMap[name];
+                Logger::log("Placed self-symmetric module " + moduleName(module) + " as left child of " + moduleName(currentNode->module));
+                currentNode->left = nodeMap[module];
                 currentNode = currentNode->left;
             }
         }
@@ -663,15 +476,15 @@ void ASFBStarTree::buildInitialBStarTree() {
             
             // First create a vertical stack using right children
             for (size_t i = 0; i < nonSelfSymModules.size(); i++) {
-                const std::string& moduleName = nonSelfSymModules[i];
+                ModuleId module = nonSelfSymModules[i];
                 
                 if (i == 0) {
                     // For the first module, we need to find the end of the rightmost branch
                     // to preserve self-symmetric modules
                     if (root->right == nullptr) {
                         // Root has no right child, safe to add directly
-                        Logger::log("Placed first non-self-symmetric module " + moduleName + " as right child of root");
-                        root->right = nodeMap[moduleName];
+                        Logger::log("Placed first non-self-symmetric module " + moduleName(module) + " as right child of root");
+                        root->right = nodeMap[module];
                         currentNode = root->right;
                     } else {
                         // Root already has a right child (self-symmetric module)
@@ -681,16 +494,16 @@ void ASFBStarTree::buildInitialBStarTree() {
                             rightmost = rightmost->right;
                         }
                         // Add as right child of the rightmost node
-                        Logger::log("Placed first non-self-symmetric module " + moduleName + 
-                                  " as right child of " + rightmost->moduleName);
-                        rightmost->right = nodeMap[moduleName];
+                        Logger::log("Placed first non-self-symmetric module " + moduleName(module) + 
+                                  " as right child of " + moduleName(rightmost->module));
+                        rightmost->right = nodeMap[module];
                         currentNode = rightmost->right;
                     }
                 } else if (i % 2 == 0) {
                     // Even indices go to right (vertical stacking)
                     if (currentNode->right == nullptr) {
-                        Logger::log("Placed module " + moduleName + " as right child of " + currentNode->moduleName);
-                        currentNode->right = nodeMap[moduleName];
+                        Logger::log("Placed module " + moduleName(module) + " as right child of " + moduleName(currentNode->module));
+                        currentNode->right = nodeMap[module];
                         currentNode = currentNode->right;
                     } else {
                         // Find a node with no right child
@@ -708,16 +521,16 @@ void ASFBStarTree::buildInitialBStarTree() {
                         findOpenRightSlot(root);
                         
                         if (target != nullptr) {
-                            Logger::log("Placed module " + moduleName + " as right child of " + target->moduleName);
-                            target->right = nodeMap[moduleName];
+                            Logger::log("Placed module " + moduleName(module) + " as right child of " + moduleName(target->module));
+                            target->right = nodeMap[module];
                             currentNode = target->right;
                         }
                     }
                 } else {
                     // Odd indices go to left (placing to the right side)
                     if (currentNode->left == nullptr) {
-                        Logger::log("Placed module " + moduleName + " as left child of " + currentNode->moduleName);
-                        currentNode->left = nodeMap[moduleName];
+                        Logger::log("Placed module " + moduleName(module) + " as left child of " + moduleName(currentNode->module));
+                        currentNode->left = nodeMap[module];
                         currentNode = currentNode->left;
                     } else {
                         // Find a node with no left child
@@ -735,8 +548,8 @@ void ASFBStarTree::buildInitialBStarTree() {
                         findOpenLeftSlot(root);
                         
                         if (target != nullptr) {
-                            Logger::log("Placed module " + moduleName + " as left child of " + target->moduleName);
-                            target->left = nodeMap[moduleName];
+                            Logger::log("Placed module " + moduleName(module) + " as left child of " + moduleName(target->module));
+                            target->left = nodeMap[module];
                             currentNode = target->left;
                         }
                     }
@@ -746,15 +559,15 @@ void ASFBStarTree::buildInitialBStarTree() {
             // For horizontal symmetry, similar but with left/right children swapped
             // Create a horizontal arrangement using left children
             for (size_t i = 0; i < nonSelfSymModules.size(); i++) {
-                const std::string& moduleName = nonSelfSymModules[i];
+                ModuleId module = nonSelfSymModules[i];
                 
                 if (i == 0) {
                     // For the first module, we need to find the end of the leftmost branch
                     // to preserve self-symmetric modules
                     if (root->left == nullptr) {
                         // Root has no left child, safe to add directly
-                        Logger::log("Placed first non-self-symmetric module " + moduleName + " as left child of root");
-                        root->left = nodeMap[moduleName];
+                        Logger::log("Placed first non-self-symmetric module " + moduleName(module) + " as left child of root");
+                        root->left = nodeMap[module];
                         currentNode = root->left;
                     } else {
                         // Root already has a left child (self-symmetric module)
@@ -764,16 +577,16 @@ void ASFBStarTree::buildInitialBStarTree() {
                             leftmost = leftmost->left;
                         }
                         // Add as left child of the leftmost node
-                        Logger::log("Placed first non-self-symmetric module " + moduleName + 
-                                  " as left child of " + leftmost->moduleName);
-                        leftmost->left = nodeMap[moduleName];
+                        Logger::log("Placed first non-self-symmetric module " + moduleName(module) + 
+                                  " as left child of " + moduleName(leftmost->module));
+                        leftmost->left = nodeMap[module];
                         currentNode = leftmost->left;
                     }
                 } else if (i % 2 == 0) {
                     // Even indices go to left (horizontal arrangement)
                     if (currentNode->left == nullptr) {
-                        Logger::log("Placed module " + moduleName + " as left child of " + currentNode->moduleName);
-                        currentNode->left = nodeMap[moduleName];
+                        Logger::log("Placed module " + moduleName(module) + " as left child of " + moduleName(currentNode->module));
+                        currentNode->left = nodeMap[module];
                         currentNode = currentNode->left;
                     } else {
                         // Find a node with no left child
@@ -791,16 +604,16 @@ void ASFBStarTree::buildInitialBStarTree() {
                         findOpenLeftSlot(root);
                         
                         if (target != nullptr) {
-                            Logger::log("Placed module " + moduleName + " as left child of " + target->moduleName);
-                            target->left = nodeMap[moduleName];
+                            Logger::log("Placed module " + moduleName(module) + " as left child of " + moduleName(target->module));
+                            target->left = nodeMap[module];
                             currentNode = target->left;
                         }
                     }
                 } else {
                     // Odd indices go to right (vertical offset)
                     if (currentNode->right == nullptr) {
-                        Logger::log("Placed module " + moduleName + " as right child of " + currentNode->moduleName);
-                        currentNode->right = nodeMap[moduleName];
+                        Logger::log("Placed module " + moduleName(module) + " as right child of " + moduleName(currentNode->module));
+                        currentNode->right = nodeMap[module];
                         currentNode = currentNode->right;
                     } else {
                         // Find a node with no right child
@@ -818,8 +631,8 @@ void ASFBStarTree::buildInitialBStarTree() {
                         findOpenRightSlot(root);
                         
                         if (target != nullptr) {
-                            Logger::log("Placed module " + moduleName + " as right child of " + target->moduleName);
-                            target->right = nodeMap[moduleName];
+                            Logger::log("Placed module " + moduleName(module) + " as right child of " + moduleName(target->module));
+                            target->right = nodeMap[module];
                             currentNode = target->right;
                         }
                     }
@@ -832,7 +645,7 @@ void ASFBStarTree::buildInitialBStarTree() {
     Logger::logTreeStructure("Initial ASF-B*-tree", root);
     
     // Validate the tree structure
-    if (!validateTreeStructure(root)) {
+    if (!checkTreeStructure(root)) {
         Logger::log("CRITICAL: Invalid tree structure after initialization");
         throw std::runtime_error("Invalid tree structure after initialization");
     }
@@ -851,8 +664,10 @@ void ASFBStarTree::buildInitialBStarTree() {
  * @return True if packing was successful
  */
 bool ASFBStarTree::pack() {
+    HW4_PROFILE_SCOPE("ASFBStarTree::pack");
     try {
         // Update the traversals for the current B*-tree
+        HW4_PROFILE_STAGE(stage, "ASFBStarTree::pack/traversals");
         preorderTraversal.clear();
         inorderTraversal.clear();
         preorder(root);
@@ -861,21 +676,41 @@ bool ASFBStarTree::pack() {
         Logger::log("Starting ASF-B*-tree packing with " + 
                    std::to_string(preorderTraversal.size()) + " nodes");
         
+        // Pull the current module state into the island geometry
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/loadGeometry");
+        loadGeometry();
+        alignSelfSymmetricParity();
+        
         // Pack the B*-tree to get coordinates for representatives
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/packBStarTree");
         packBStarTree();
         
         // Calculate the symmetry axis position
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/symmetryAxis");
+        separateSelfSymmetricModules();
         calculateSymmetryAxisPosition();
         
         // Update positions of symmetric modules
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/symmetricModules");
         updateSymmetricModulePositions();
         
+        // Publish the packed island back to the Module objects
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/storeGeometry");
+        storeGeometry();
+        
         // Validate the resulting placement satisfies symmetry constraints
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/validateSymmetry");
         if (!validateSymmetry()) {
             Logger::log("ERROR: Placement does not satisfy symmetry constraints");
             return false;
         }
         
+        HW4_PROFILE_NEXT_STAGE(stage, "ASFBStarTree::pack/validateNoOverlaps");
+        if (!validateNoOverlaps()) {
+            Logger::log("ERROR: Modules of the symmetry island overlap");
+            return false;
+        }
+        
         return true;
     } catch (const std::exception& e) {
         Logger::log("Exception during packing: " + std::string(e.what()));
@@ -889,116 +724,93 @@ bool ASFBStarTree::pack() {
  * Validate if the symmetry is maintained, with improved error reporting
  */
 bool ASFBStarTree::validateSymmetry() const {
-    try {
-        // First check for negative coordinates which would invalidate the placement
-        for (const auto& pair : modules) {
-            const auto& module = pair.second;
-            if (module->getX() < 0 || module->getY() < 0) {
-                Logger::log("ERROR: Module " + pair.first + " has negative coordinates (" + 
-                          std::to_string(module->getX()) + ", " + 
-                          std::to_string(module->getY()) + ")");
-                return false;
-            }
-        }
-        
-        // Validate symmetry pairs have correct placements
-        for (const auto& pair : repToPairMap) {
-            // Safety check: Make sure both modules exist
-            auto repIt = modules.find(pair.first);
-            auto symIt = modules.find(pair.second);
-            
-            if (repIt == modules.end() || symIt == modules.end()) {
-                Logger::log("WARNING: Cannot validate symmetry for missing modules: " + 
-                          pair.first + " or " + pair.second);
-                continue;
-            }
-            
-            const std::string& repName = pair.first;
-            const std::string& symName = pair.second;
-            
-            std::shared_ptr<Module> repModule = repIt->second;
-            std::shared_ptr<Module> symModule = symIt->second;
-            
-            // Calculate centers
-            double repCenterX = repModule->getX() + repModule->getWidth() / 2.0;
-            double repCenterY = repModule->getY() + repModule->getHeight() / 2.0;
-            double symCenterX = symModule->getX() + symModule->getWidth() / 2.0;
-            double symCenterY = symModule->getY() + symModule->getHeight() / 2.0;
-            
-            if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
-                // Check vertical symmetry equation
-                double expectedSum = 2 * symmetryAxisPosition;
-                double actualSum = repCenterX + symCenterX;
-                double error = std::abs(expectedSum - actualSum);
-                
-                // Also check y-coordinates match
-                double yError = std::abs(repCenterY - symCenterY);
-                
-                if (error > 1.0 || yError > 1.0) {  // Allow small floating-point error
-                    Logger::log("ERROR: Symmetry violation for pair (" + repName + ", " + symName + ")");
-                    Logger::log("  Expected: repCenterX + symCenterX = " + std::to_string(expectedSum));
-                    Logger::log("  Actual: " + std::to_string(repCenterX) + " + " + std::to_string(symCenterX) + " = " + std::to_string(actualSum));
-                    Logger::log("  Y error: " + std::to_string(yError));
-                    return false;
-                }
-            } else {
-                // Check horizontal symmetry equation
-                double expectedSum = 2 * symmetryAxisPosition;
-                double actualSum = repCenterY + symCenterY;
-                double error = std::abs(expectedSum - actualSum);
-                
-                // Also check x-coordinates match
-                double xError = std::abs(repCenterX - symCenterX);
-                
-                if (error > 1.0 || xError > 1.0) {  // Allow small floating-point error
-                    Logger::log("ERROR: Symmetry violation for pair (" + repName + ", " + symName + ")");
-                    Logger::log("  Expected: repCenterY + symCenterY = " + std::to_string(expectedSum));
-                    Logger::log("  Actual: " + std::to_string(repCenterY) + " + " + std::to_string(symCenterY) + " = " + std::to_string(actualSum));
-                    Logger::log("  X error: " + std::to_string(xError));
-                    return false;
-                }
-            }
-        }
-        
-        // Check self-symmetric modules are centered on the axis
-        for (const auto& moduleName : selfSymmetricModules) {
-            // Safety check: Make sure module exists
-            auto moduleIt = modules.find(moduleName);
-            if (moduleIt == modules.end()) {
-                Logger::log("WARNING: Cannot validate symmetry for missing self-symmetric module: " + moduleName);
-                continue;
-            }
-            
-            std::shared_ptr<Module> module = moduleIt->second;
-            double centerX = module->getX() + module->getWidth() / 2.0;
-            double centerY = module->getY() + module->getHeight() / 2.0;
-            
-            if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
-                double error = std::abs(centerX - symmetryAxisPosition);
-                if (error > 1.0) {  // Allow small floating-point error
-                    Logger::log("ERROR: Self-symmetric module " + moduleName + " not centered on axis");
-                    Logger::log("  Module center: " + std::to_string(centerX));
-                    Logger::log("  Axis position: " + std::to_string(symmetryAxisPosition));
-                    return false;
-                }
-            } else {
-                double error = std::abs(centerY - symmetryAxisPosition);
-                if (error > 1.0) {  // Allow small floating-point error
-                    Logger::log("ERROR: Self-symmetric module " + moduleName + " not centered on axis");
-                    Logger::log("  Module center: " + std::to_string(centerY));
-                    Logger::log("  Axis position: " + std::to_string(symmetryAxisPosition));
-                    return false;
-                }
-            }
+    // First check for negative coordinates which would invalidate the placement
+    for (size_t i = 0; i < geometry.size(); i++) {
+        if (geometry.x[i] < 0 || geometry.y[i] < 0) {
+            Logger::log("ERROR: Module " + moduleName(geometry.modules[i]) + " has negative coordinates (" + 
+                      std::to_string(geometry.x[i]) + ", " + std::to_string(geometry.y[i]) + ")");
+            return false;
         }
-        
-        // If all checks pass, the symmetry is valid
-        Logger::log("Symmetry validation passed");
-        return true;
-    } catch (const std::exception& e) {
-        Logger::log("Exception in validateSymmetry: " + std::string(e.what()));
+    }
+    
+    // Positions and the axis are integral in half-units, so the check is exact.
+    // If no axis can center every self-symmetric module, the closest
+    // placement (half a unit off) is accepted for them.
+    const int tolerance2 = 0;
+    const int selfTolerance2 = exactSymmetryPossible ? 0 : 1;
+    
+    gatherPairLanes();
+    const PairLanes& lanes = pairLanes;
+    
+    // Validate symmetry pairs have correct placements
+    long badPair = SymmetryKernels::findPairViolation(
+        pairRepIds.size(), symmetryAxis2, tolerance2,
+        lanes.repPos.data(), lanes.repLen.data(), lanes.repCross.data(), lanes.repCrossLen.data(),
+        lanes.symPos.data(), lanes.symLen.data(), lanes.symCross.data(), lanes.symCrossLen.data());
+    
+    if (badPair >= 0) {
+        size_t i = static_cast<size_t>(badPair);
+        Logger::log("ERROR: Symmetry violation for pair (" + moduleName(geometry.modules[pairRepIds[i]]) + ", " + 
+                   moduleName(geometry.modules[pairSymIds[i]]) + ")");
+        Logger::log("  Expected doubled center sum: " + std::to_string(2 * symmetryAxis2));
+        Logger::log("  Actual doubled center sum: " + 
+                   std::to_string(2 * lanes.repPos[i] + lanes.repLen[i] + 2 * lanes.symPos[i] + lanes.symLen[i]));
         return false;
     }
+    
+    // Check self-symmetric modules are centered on the axis
+    long badSelf = SymmetryKernels::findSelfSymmetricViolation(
+        selfSymIds.size(), symmetryAxis2, selfTolerance2, lanes.selfPos.data(), lanes.selfLen.data());
+    
+    if (badSelf >= 0) {
+        size_t i = static_cast<size_t>(badSelf);
+        Logger::log("ERROR: Self-symmetric module " + moduleName(geometry.modules[selfSymIds[i]]) + " not centered on axis");
+        Logger::log("  Module center: " + std::to_string(lanes.selfPos[i] + lanes.selfLen[i] / 2.0));
+        Logger::log("  Axis position: " + std::to_string(symmetryAxisPosition));
+        return false;
+    }
+    
+    // If all checks pass, the symmetry is valid
+    Logger::log("Symmetry validation passed");
+    return true;
+}
+
+/**
+ * Validates the current module positions without repacking
+ */
+bool ASFBStarTree::validatePlacement() {
+    loadGeometry();
+    
+    // The layout is fixed, so exact symmetry needs one parity as it stands
+    bool vertical = symmetryGroup->getType() == SymmetryType::VERTICAL;
+    const std::vector<int>& len = vertical ? geometry.w : geometry.h;
+    exactSymmetryPossible = true;
+    for (int id : selfSymIds) {
+        if ((len[id] & 1) != (len[selfSymIds[0]] & 1)) {
+            exactSymmetryPossible = false;
+        }
+    }
+    
+    return validateSymmetry() && validateNoOverlaps();
+}
+
+/**
+ * Checks the island's modules for pairwise overlaps
+ */
+bool ASFBStarTree::validateNoOverlaps() {
+    overlapDetector.clear();
+    for (size_t i = 0; i < geometry.size(); i++) {
+        const Module& module = *geometry.refs[i];
+        overlapDetector.addRect(static_cast<int>(i), module.getX(), module.getY(),
+                                module.getWidth(), module.getHeight());
+    }
+    
+    const auto& overlaps = overlapDetector.findOverlaps();
+    for (const auto& pair : overlaps) {
+        Logger::log("ERROR: Modules " + moduleName(geometry.modules[pair.first]) + " and " +
+                   moduleName(geometry.modules[pair.second]) + " overlap inside the symmetry island");
+    }
+    return overlaps.empty();
 }
 
 /**
@@ -1012,14 +824,13 @@ bool ASFBStarTree::validateConnectivity() {
     if (modules.empty()) return true;
     
     // Build position and dimension maps for the isSymmetryIsland check
-    std::unordered_map<std::string, std::pair<int, int>> positions;
-    std::unordered_map<std::string, std::pair<int, int>> dimensions;
+    std::unordered_map<ModuleId, std::pair<int, int>> positions;
+    std::unordered_map<ModuleId, std::pair<int, int>> dimensions;
     
     for (const auto& pair : modules) {
-        const std::string& name = pair.first;
         const auto& module = pair.second;
-        positions[name] = {module->getX(), module->getY()};
-        dimensions[name] = {module->getWidth(), module->getHeight()};
+        positions[pair.first] = {module->getX(), module->getY()};
+        dimensions[pair.first] = {module->getWidth(), module->getHeight()};
     }
     
     // Use the isSymmetryIsland function from SymmetryGroup
@@ -1038,13 +849,8 @@ bool ASFBStarTree::validateConnectivity() {
  * Helper function to check if placing a module would overlap with existing contour
  */
 bool ASFBStarTree::hasContourOverlap(int x, int y, int width, int height) {
-    int right = x + width;
-    for (int currX = x; currX < right; currX++) {
-        if (getContourHeight(currX) > y) {
-            return true;
-        }
-    }
-    return false;
+    (void)height;
+    return contour.maxHeight(x, x + width) > y;
 }
 
 /**
@@ -1076,8 +882,8 @@ void ASFBStarTree::optimizeModulePositions() {
     }
     
     // Collect module positions
-    std::unordered_map<std::string, std::pair<int, int>> positions;
-    std::unordered_map<std::string, std::pair<int, int>> dimensions;
+    std::unordered_map<ModuleId, std::pair<int, int>> positions;
+    std::unordered_map<ModuleId, std::pair<int, int>> dimensions;
     
     for (const auto& pair : representativeModules) {
         const auto& module = modules[pair.first];
@@ -1090,23 +896,23 @@ void ASFBStarTree::optimizeModulePositions() {
     // while preserving relative positions (connectivity)
     
     // 1. Sort modules by x-coordinate
-    std::vector<std::string> modulesByX;
+    std::vector<ModuleId> modulesByX;
     for (const auto& pair : representativeModules) {
         modulesByX.push_back(pair.first);
     }
     
-    std::sort(modulesByX.begin(), modulesByX.end(), [&positions](const std::string& a, const std::string& b) {
+    std::sort(modulesByX.begin(), modulesByX.end(), [&positions](ModuleId a, ModuleId b) {
         return positions[a].first < positions[b].first;
     });
     
     // 2. Compact in X direction (left-to-right scan)
     for (size_t i = 1; i < modulesByX.size(); ++i) {
-        const std::string& currModule = modulesByX[i];
+        ModuleId currModule = modulesByX[i];
         int minPossibleX = 0;
         
         // Find the rightmost edge of any module that is to the left of current module
         for (size_t j = 0; j < i; ++j) {
-            const std::string& prevModule = modulesByX[j];
+            ModuleId prevModule = modulesByX[j];
             const auto& prevPos = positions[prevModule];
             const auto& prevDim = dimensions[prevModule];
             const auto& currPos = positions[currModule];
@@ -1129,23 +935,23 @@ void ASFBStarTree::optimizeModulePositions() {
     }
     
     // 3. Sort modules by y-coordinate
-    std::vector<std::string> modulesByY;
+    std::vector<ModuleId> modulesByY;
     for (const auto& pair : representativeModules) {
         modulesByY.push_back(pair.first);
     }
     
-    std::sort(modulesByY.begin(), modulesByY.end(), [&positions](const std::string& a, const std::string& b) {
+    std::sort(modulesByY.begin(), modulesByY.end(), [&positions](ModuleId a, ModuleId b) {
         return positions[a].second < positions[b].second;
     });
     
     // 4. Compact in Y direction (bottom-to-top scan)
     for (size_t i = 1; i < modulesByY.size(); ++i) {
-        const std::string& currModule = modulesByY[i];
+        ModuleId currModule = modulesByY[i];
         int minPossibleY = 0;
         
         // Find the topmost edge of any module that is below current module
         for (size_t j = 0; j < i; ++j) {
-            const std::string& prevModule = modulesByY[j];
+            ModuleId prevModule = modulesByY[j];
             const auto& prevPos = positions[prevModule];
             const auto& prevDim = dimensions[prevModule];
             const auto& currPos = positions[currModule];
@@ -1169,15 +975,47 @@ void ASFBStarTree::optimizeModulePositions() {
     
     // 5. Update module positions
     for (const auto& pair : positions) {
-        const std::string& moduleName = pair.first;
         const auto& pos = pair.second;
         
-        modules[moduleName]->setPosition(pos.first, pos.second);
+        modules[pair.first]->setPosition(pos.first, pos.second);
     }
     
     Logger::log("Module positions optimized for compact placement");
 }
 
+/**
+ * Shifts each module in `order` towards the origin along one axis as far as
+ * the modules before it allow. `pos`/`len` are the coordinate and extent along
+ * the compaction axis, `crossPos`/`crossLen` along the other axis.
+ */
+static void compactAlongAxis(const std::vector<int>& order,
+                             std::vector<int>& pos, const std::vector<int>& len,
+                             const std::vector<int>& crossPos, const std::vector<int>& crossLen) {
+    for (size_t i = 1; i < order.size(); i++) {
+        int curr = order[i];
+        
+        // Try to shift this module as much as possible without overlapping
+        int maxShift = pos[curr];
+        
+        for (size_t j = 0; j < i; j++) {
+            int prev = order[j];
+            
+            // Check if there's a potential overlap on the cross axis
+            bool crossOverlap = !(crossPos[prev] + crossLen[prev] <= crossPos[curr] ||
+                                  crossPos[curr] + crossLen[curr] <= crossPos[prev]);
+            
+            if (crossOverlap) {
+                maxShift = std::min(maxShift, pos[curr] - (pos[prev] + len[prev]));
+            }
+        }
+        
+        // Apply the shift
+        if (maxShift > 0) {
+            pos[curr] -= maxShift;
+        }
+    }
+}
+
 /**
  * Apply compaction to minimize area while preserving symmetry constraints
  * This function tries to compact the placement in X and Y directions
@@ -1185,216 +1023,48 @@ void ASFBStarTree::optimizeModulePositions() {
 void ASFBStarTree::compactPlacement() {
     Logger::log("Applying compaction to minimize area");
     
-    // Create a copy of the current positions for working
-    std::unordered_map<std::string, std::pair<int, int>> positions;
-    std::unordered_map<std::string, std::pair<int, int>> dimensions;
+    if (repIds.empty()) return;
     
-    for (const auto& pair : representativeModules) {
-        const auto& module = modules[pair.first];
-        positions[pair.first] = {module->getX(), module->getY()};
-        dimensions[pair.first] = {module->getWidth(), module->getHeight()};
-    }
+    std::vector<int>& xs = geometry.x;
+    std::vector<int>& ys = geometry.y;
+    const std::vector<int>& ws = geometry.w;
+    const std::vector<int>& hs = geometry.h;
     
     // Find minimum X and Y to ensure all modules have positive coordinates
     int minX = std::numeric_limits<int>::max();
     int minY = std::numeric_limits<int>::max();
     
-    for (const auto& pair : positions) {
-        minX = std::min(minX, pair.second.first);
-        minY = std::min(minY, pair.second.second);
+    for (int id : repIds) {
+        minX = std::min(minX, xs[id]);
+        minY = std::min(minY, ys[id]);
     }
     
     // Shift all modules to ensure positive coordinates
     if (minX > 0 || minY > 0) {
-        for (auto& pair : positions) {
-            pair.second.first -= minX;
-            pair.second.second -= minY;
+        for (int id : repIds) {
+            xs[id] -= minX;
+            ys[id] -= minY;
         }
     }
     
-    // For vertical symmetry, focus on minimizing width
+    std::vector<int> order = repIds;
+    auto byX = [&xs](int a, int b) { return xs[a] < xs[b]; };
+    auto byY = [&ys](int a, int b) { return ys[a] < ys[b]; };
+    
+    // For vertical symmetry, focus on minimizing width; for horizontal, height
     if (symmetryGroup->getType() == SymmetryType::VERTICAL) {
-        // Sort modules by x-coordinate
-        std::vector<std::string> modulesByX;
-        for (const auto& pair : positions) {
-            modulesByX.push_back(pair.first);
-        }
+        std::stable_sort(order.begin(), order.end(), byX);
+        compactAlongAxis(order, xs, ws, ys, hs);
         
-        std::sort(modulesByX.begin(), modulesByX.end(), [&positions](const std::string& a, const std::string& b) {
-            return positions[a].first < positions[b].first;
-        });
-        
-        // Compact in X direction by shifting modules to the left when possible
-        for (size_t i = 1; i < modulesByX.size(); i++) {
-            const std::string& currModule = modulesByX[i];
-            int currX = positions[currModule].first;
-            int currY = positions[currModule].second;
-            int currWidth = dimensions[currModule].first;
-            int currHeight = dimensions[currModule].second;
-            
-            // Try to shift this module left as much as possible without overlapping
-            int maxLeftShift = currX;
-            
-            for (size_t j = 0; j < i; j++) {
-                const std::string& prevModule = modulesByX[j];
-                int prevX = positions[prevModule].first;
-                int prevY = positions[prevModule].second;
-                int prevWidth = dimensions[prevModule].first;
-                int prevHeight = dimensions[prevModule].second;
-                
-                // Check if there's a potential overlap in Y direction
-                bool yOverlap = !(prevY + prevHeight <= currY || currY + currHeight <= prevY);
-                
-                if (yOverlap) {
-                    // If they could overlap in Y, calculate the minimum X distance needed
-                    maxLeftShift = std::min(maxLeftShift, currX - (prevX + prevWidth));
-                }
-            }
-            
-            // Apply the shift
-            if (maxLeftShift > 0) {
-                positions[currModule].first -= maxLeftShift;
-            }
-        }
-        
-        // Sort modules by y-coordinate to compact in Y direction
-        std::vector<std::string> modulesByY;
-        for (const auto& pair : positions) {
-            modulesByY.push_back(pair.first);
-        }
-        
-        std::sort(modulesByY.begin(), modulesByY.end(), [&positions](const std::string& a, const std::string& b) {
-            return positions[a].second < positions[b].second;
-        });
-        
-        // Compact in Y direction by shifting modules down when possible
-        for (size_t i = 1; i < modulesByY.size(); i++) {
-            const std::string& currModule = modulesByY[i];
-            int currX = positions[currModule].first;
-            int currY = positions[currModule].second;
-            int currWidth = dimensions[currModule].first;
-            int currHeight = dimensions[currModule].second;
-            
-            // Try to shift this module down as much as possible without overlapping
-            int maxDownShift = currY;
-            
-            for (size_t j = 0; j < i; j++) {
-                const std::string& prevModule = modulesByY[j];
-                int prevX = positions[prevModule].first;
-                int prevY = positions[prevModule].second;
-                int prevWidth = dimensions[prevModule].first;
-                int prevHeight = dimensions[prevModule].second;
-                
-                // Check if there's a potential overlap in X direction
-                bool xOverlap = !(prevX + prevWidth <= currX || currX + currWidth <= prevX);
-                
-                if (xOverlap) {
-                    // If they could overlap in X, calculate the minimum Y distance needed
-                    maxDownShift = std::min(maxDownShift, currY - (prevY + prevHeight));
-                }
-            }
-            
-            // Apply the shift
-            if (maxDownShift > 0) {
-                positions[currModule].second -= maxDownShift;
-            }
-        }
+        std::stable_sort(order.begin(), order.end(), byY);
+        compactAlongAxis(order, ys, hs, xs, ws);
     } else {
-        // For horizontal symmetry, focus on minimizing height
-        // Sort modules by y-coordinate
-        std::vector<std::string> modulesByY;
-        for (const auto& pair : positions) {
-            modulesByY.push_back(pair.first);
-        }
-        
-        std::sort(modulesByY.begin(), modulesByY.end(), [&positions](const std::string& a, const std::string& b) {
-            return positions[a].second < positions[b].second;
-        });
-        
-        // Compact in Y direction by shifting modules down when possible
-        for (size_t i = 1; i < modulesByY.size(); i++) {
-            const std::string& currModule = modulesByY[i];
-            int currX = positions[currModule].first;
-            int currY = positions[currModule].second;
-            int currWidth = dimensions[currModule].first;
-            int currHeight = dimensions[currModule].second;
-            
-            // Try to shift this module down as much as possible without overlapping
-            int maxDownShift = currY;
-            
-            for (size_t j = 0; j < i; j++) {
-                const std::string& prevModule = modulesByY[j];
-                int prevX = positions[prevModule].first;
-                int prevY = positions[prevModule].second;
-                int prevWidth = dimensions[prevModule].first;
-                int prevHeight = dimensions[prevModule].second;
-                
-                // Check if there's a potential overlap in X direction
-                bool xOverlap = !(prevX + prevWidth <= currX || currX + currWidth <= prevX);
-                
-                if (xOverlap) {
-                    // If they could overlap in X, calculate the minimum Y distance needed
-                    maxDownShift = std::min(maxDownShift, currY - (prevY + prevHeight));
-                }
-            }
-            
-            // Apply the shift
-            if (maxDownShift > 0) {
-                positions[currModule].second -= maxDownShift;
-            }
-        }
+        std::stable_sort(order.begin(), order.end(), byY);
+        compactAlongAxis(order, ys, hs, xs, ws);
         
-        // Sort modules by x-coordinate to compact in X direction
-        std::vector<std::string> modulesByX;
-        for (const auto& pair : positions) {
-            modulesByX.push_back(pair.first);
-        }
-        
-        std::sort(modulesByX.begin(), modulesByX.end(), [&positions](const std::string& a, const std::string& b) {
-            return positions[a].first < positions[b].first;
-        });
-        
-        // Compact in X direction by shifting modules left when possible
-        for (size_t i = 1; i < modulesByX.size(); i++) {
-            const std::string& currModule = modulesByX[i];
-            int currX = positions[currModule].first;
-            int currY = positions[currModule].second;
-            int currWidth = dimensions[currModule].first;
-            int currHeight = dimensions[currModule].second;
-            
-            // Try to shift this module left as much as possible without overlapping
-            int maxLeftShift = currX;
-            
-            for (size_t j = 0; j < i; j++) {
-                const std::string& prevModule = modulesByX[j];
-                int prevX = positions[prevModule].first;
-                int prevY = positions[prevModule].second;
-                int prevWidth = dimensions[prevModule].first;
-                int prevHeight = dimensions[prevModule].second;
-                
-                // Check if there's a potential overlap in Y direction
-                bool yOverlap = !(prevY + prevHeight <= currY || currY + currHeight <= prevY);
-                
-                if (yOverlap) {
-                    // If they could overlap in Y, calculate the minimum X distance needed
-                    maxLeftShift = std::min(maxLeftShift, currX - (prevX + prevWidth));
-                }
-            }
-            
-            // Apply the shift
-            if (maxLeftShift > 0) {
-                positions[currModule].first -= maxLeftShift;
-            }
-        }
-    }
-    
-    // Update module positions
-    for (const auto& pair : positions) {
-        const std::string& moduleName = pair.first;
-        const auto& pos = pair.second;
-        
-        modules[moduleName]->setPosition(pos.first, pos.second);
+        std::stable_sort(order.begin(), order.end(), byX);
+        compactAlongAxis(order, xs, ws, ys, hs);
     }
     
     Logger::log("Compaction complete for tight symmetry island packing");
-}
\ No newline at end of file
+}
@@ -13,9 +13,12 @@
 #include <iostream>
 #include <queue>
 #include <functional> // Added for std::function
+#include <cassert>
 
 #include "Module.hpp"
 #include "SymmetryConstraint.hpp"
+#include "Contour.hpp"
+#include "OverlapDetector.hpp"
 #include "../Logger.hpp"
 
 /**
@@ -30,55 +33,116 @@ public:
     // Symmetry group represented by this ASF-B*-tree
     std::shared_ptr<SymmetryGroup> symmetryGroup;
     
-    // Module map: module name -> module pointer
-    std::map<std::string, std::shared_ptr<Module>> modules;
+    // Module map: module id -> module pointer
+    std::map<ModuleId, std::shared_ptr<Module>> modules;
     
     // Map to store representative modules for each symmetry pair and self-symmetric module
-    std::map<std::string, std::shared_ptr<Module>> representativeModules;
+    std::map<ModuleId, std::shared_ptr<Module>> representativeModules;
     
     // Map to store the relationship between representative and non-representative modules
-    std::unordered_map<std::string, std::string> pairMap; // non-rep -> rep
-    std::unordered_map<std::string, std::string> repToPairMap; // rep -> non-rep
+    std::unordered_map<ModuleId, ModuleId> pairMap; // non-rep -> rep
+    std::unordered_map<ModuleId, ModuleId> repToPairMap; // rep -> non-rep
     
     // Self-symmetric modules (center on symmetry axis)
-    std::vector<std::string> selfSymmetricModules;
+    std::vector<ModuleId> selfSymmetricModules;
+    
+    /**
+     * @brief Structure-of-arrays geometry of the island
+     * 
+     * Every module of the group gets a dense local id (its index in these
+     * arrays, assigned in module id order). Packing, mirroring, compaction
+     * and validation only touch these arrays; the Module objects are read
+     * when a pack starts (loadGeometry) and written back when it ends
+     * (storeGeometry).
+     */
+    struct IslandGeometry {
+        std::vector<ModuleId> modules;              // Local id -> module id
+        std::vector<std::shared_ptr<Module>> refs;  // Local id -> module, used for boundary sync only
+        std::vector<int> x;
+        std::vector<int> y;
+        std::vector<int> w;                         // Effective width (rotation applied)
+        std::vector<int> h;                         // Effective height (rotation applied)
+        std::vector<char> rotated;
+        std::vector<int> paired;                    // Local id of the symmetric partner, -1 if self-symmetric
+        std::vector<char> representative;           // Non-zero if the module is a representative
+        
+        size_t size() const { return modules.size(); }
+        
+        void resize(size_t n) {
+            modules.resize(n);
+            refs.resize(n);
+            x.assign(n, 0);
+            y.assign(n, 0);
+            w.assign(n, 0);
+            h.assign(n, 0);
+            rotated.assign(n, 0);
+            paired.assign(n, -1);
+            representative.assign(n, 0);
+        }
+    };
+    
+    IslandGeometry geometry;
+    
+    // Module id -> local id (only consulted outside the packing loops)
+    std::unordered_map<ModuleId, int> localIds;
+    
+    // Index lists rebuilt from the geometry at the start of every pack
+    std::vector<int> repIds;      // All representatives, in local id order
+    std::vector<int> pairRepIds;  // Representative of each symmetry pair
+    std::vector<int> pairSymIds;  // Non-representative matching pairRepIds[i]
+    std::vector<int> selfSymIds;  // Self-symmetric modules
     
     // B*-tree representation (for representatives only)
     struct BStarNode {
-        std::string moduleName;
+        ModuleId module;
+        int id;           // Local id of the module in the island geometry
         BStarNode* left;  // Left child: left-adjacent module
         BStarNode* right; // Right child: top-adjacent module
         
-        BStarNode(const std::string& name) : moduleName(name), left(nullptr), right(nullptr) {}
+        BStarNode(ModuleId module, int id = -1) : module(module), id(id), left(nullptr), right(nullptr) {}
     };
     
     // Root of the B*-tree
     BStarNode* root;
 
-    // Backup storage for tree structure
+    // Backup storage for tree structure, as local ids
     struct TreeBackup {
-        std::vector<std::string> preorderTraversal;
-        std::vector<std::string> inorderTraversal;
+        std::vector<int> preorderTraversal;
+        std::vector<int> inorderTraversal;
     };
     TreeBackup treeBackup;
     
     // Current symmetry axis position
     double symmetryAxisPosition;
     
+    // Symmetry axis in integer half-units (2 * symmetryAxisPosition)
+    int symmetryAxis2;
+    
+    // False when no rotation gives the self-symmetric lengths one parity, so no axis centers them all
+    bool exactSymmetryPossible;
+    
+    // Pair geometry gathered into contiguous lanes for the symmetry kernels.
+    // "Pos"/"Len" run along the symmetry direction, "Cross" along the other axis.
+    struct PairLanes {
+        std::vector<int> repPos, repLen, repCross, repCrossLen;
+        std::vector<int> symPos, symLen, symCross, symCrossLen;
+        std::vector<int> selfPos, selfLen;
+    };
+    mutable PairLanes pairLanes;
+    
     // Preorder and inorder traversals of the B*-tree
     std::vector<BStarNode*> preorderTraversal;
     std::vector<BStarNode*> inorderTraversal;
     
-    // Contour data structure for packing
-    struct ContourPoint {
-        int x;
-        int height;
-        ContourPoint* next;
-        
-        ContourPoint(int x, int height) : x(x), height(height), next(nullptr) {}
-    };
+    // Level-order work list reused across packs
+    std::vector<BStarNode*> packQueue;
     
-    ContourPoint* contourHead;
+    // Skyline contour for packing, and its breakpoint buffer (both reused across packs)
+    Contour contour;
+    std::vector<int> contourBreakpoints;
+    
+    // Sweep-line detector for overlaps between the island's own modules
+    OverlapDetector overlapDetector;
     
     /**
      * Constructor
@@ -86,12 +150,13 @@ public:
      * @param symmetryGroup The symmetry group to represent
      * @param modules Map of all modules
      */
-    ASFBStarTree(std::shared_ptr<SymmetryGroup> symmetryGroup, const std::map<std::string, std::shared_ptr<Module>>& modules)
+    ASFBStarTree(std::shared_ptr<SymmetryGroup> symmetryGroup, const std::map<ModuleId, std::shared_ptr<Module>>& modules)
         : symmetryGroup(symmetryGroup), 
           modules(modules), 
           root(nullptr), 
           symmetryAxisPosition(-1),
-          contourHead(nullptr) {
+          symmetryAxis2(-2),
+          exactSymmetryPossible(true) {
         
         // Initialize module relationships
         initializeRepresentatives();
@@ -105,7 +170,6 @@ public:
      */
     ~ASFBStarTree() {
         cleanupTree(root);
-        clearContour();
     }
     
     /**
@@ -121,26 +185,114 @@ public:
         
         // Process symmetry pairs
         for (const auto& pair : symmetryGroup->getSymmetryPairs()) {
-            const std::string& module1 = pair.first;
-            const std::string& module2 = pair.second;
-            
             // According to Definition 2: The representative b_j^r of a symmetry pair (b_j, b'_j) is b'_j
-            const std::string& rep = module2;
-            const std::string& sym = module1;
+            ModuleId rep = pair.second;
+            ModuleId sym = pair.first;
             
             representativeModules[rep] = modules[rep];
             pairMap[sym] = rep;
             repToPairMap[rep] = sym;
             
-            Logger::log("Added symmetry pair: " + sym + " -> " + rep + " (rep)");
+            Logger::log("Added symmetry pair: " + moduleName(sym) + " -> " + moduleName(rep) + " (rep)");
         }
         
         // Process self-symmetric modules
-        for (const auto& moduleName : symmetryGroup->getSelfSymmetric()) {
-            selfSymmetricModules.push_back(moduleName);
-            representativeModules[moduleName] = modules[moduleName];
+        for (ModuleId module : symmetryGroup->getSelfSymmetric()) {
+            selfSymmetricModules.push_back(module);
+            representativeModules[module] = modules[module];
+            
+            Logger::log("Added self-symmetric module: " + moduleName(module));
+        }
+        
+        initializeGeometry();
+    }
+    
+    /**
+     * Assigns dense local ids and fills the static part of the island geometry
+     * (module ids and references, pairing and representative flags)
+     */
+    void initializeGeometry() {
+        geometry.resize(modules.size());
+        localIds.clear();
+        
+        int id = 0;
+        for (const auto& pair : modules) {
+            geometry.modules[id] = pair.first;
+            geometry.refs[id] = pair.second;
+            localIds[pair.first] = id;
+            id++;
+        }
+        
+        for (const auto& pair : repToPairMap) {
+            int repId = localIds[pair.first];
+            int symId = localIds[pair.second];
+            geometry.paired[repId] = symId;
+            geometry.paired[symId] = repId;
+            geometry.representative[repId] = 1;
+        }
+        
+        for (ModuleId module : selfSymmetricModules) {
+            geometry.representative[localIds[module]] = 1;
+        }
+    }
+    
+    /**
+     * Updates the representative flag of a module in the island geometry
+     */
+    void setRepresentativeFlag(ModuleId module, bool isRep) {
+        geometry.representative[localIds[module]] = isRep ? 1 : 0;
+    }
+    
+    /**
+     * Reads dimensions, rotation and positions from the Module objects into
+     * the island geometry and rebuilds the per-pack index lists
+     */
+    void loadGeometry() {
+        repIds.clear();
+        pairRepIds.clear();
+        pairSymIds.clear();
+        selfSymIds.clear();
+        
+        for (size_t i = 0; i < geometry.size(); i++) {
+            const Module& module = *geometry.refs[i];
+            geometry.x[i] = module.getX();
+            geometry.y[i] = module.getY();
+            geometry.w[i] = module.getWidth();
+            geometry.h[i] = module.getHeight();
+            geometry.rotated[i] = module.getRotated() ? 1 : 0;
             
-            Logger::log("Added self-symmetric module: " + moduleName);
+            if (!geometry.representative[i]) continue;
+            
+            int id = static_cast<int>(i);
+            repIds.push_back(id);
+            if (geometry.paired[i] >= 0) {
+                pairRepIds.push_back(id);
+                pairSymIds.push_back(geometry.paired[i]);
+            } else {
+                selfSymIds.push_back(id);
+            }
+        }
+    }
+    
+    /**
+     * Writes positions and rotation from the island geometry back to the Module objects
+     */
+    void storeGeometry() {
+        for (size_t i = 0; i < geometry.size(); i++) {
+            Module& module = *geometry.refs[i];
+            module.setRotation(geometry.rotated[i] != 0);
+            module.setPosition(geometry.x[i], geometry.y[i]);
+        }
+    }
+    
+    /**
+     * Sets the rotation of a module in the island geometry, swapping its
+     * effective dimensions when the rotation changes
+     */
+    void setGeometryRotation(int id, bool rotate) {
+        if ((geometry.rotated[id] != 0) != rotate) {
+            std::swap(geometry.w[id], geometry.h[id]);
+            geometry.rotated[id] = rotate ? 1 : 0;
         }
     }
     
@@ -159,16 +311,16 @@ public:
         if (root == nullptr) return true;
         
         // For each self-symmetric module, check if it's on the correct branch
-        for (const auto& moduleName : selfSymmetricModules) {
+        for (ModuleId module : selfSymmetricModules) {
             // Skip the root as it's always valid
-            if (root->moduleName == moduleName) continue;
+            if (root->module == module) continue;
             
             bool foundOnCorrectBranch = false;
             
             // Check if the module is on the correct branch
             BStarNode* current = root;
             while (current != nullptr) {
-                if (current->moduleName == moduleName) {
+                if (current->module == module) {
                     foundOnCorrectBranch = true;
                     break;
                 }
@@ -181,7 +333,7 @@ public:
             }
             
             if (!foundOnCorrectBranch) {
-                Logger::log("Self-symmetric module " + moduleName + " is not on the correct branch");
+                Logger::log("Self-symmetric module " + moduleName(module) + " is not on the correct branch");
                 return false;
             }
         }
@@ -195,7 +347,7 @@ public:
     bool validateTreeStructure(BStarNode* node) {
         if (node == nullptr) return true;
         
-        Logger::log("Validating tree structure starting at " + (node == root ? "root" : node->moduleName));
+        Logger::log("Validating tree structure starting at " + (node == root ? "root" : moduleName(node->module)));
         
         // Set to keep track of visited nodes
         std::unordered_set<BStarNode*> visited;
@@ -261,8 +413,8 @@ public:
         std::function<bool(BStarNode*)> verifyModuleExists = [&](BStarNode* n) -> bool {
             if (n == nullptr) return true;
             
-            if (modules.find(n->moduleName) == modules.end()) {
-                Logger::log("Node " + n->moduleName + " doesn't exist in modules map!");
+            if (modules.find(n->module) == modules.end()) {
+                Logger::log("Node " + moduleName(n->module) + " doesn't exist in modules map!");
                 return false;
             }
             
@@ -280,50 +432,44 @@ public:
     }
     
     /**
-     * Clears the contour data structure
+     * Structural check run after perturbations, restores and rebuilds
+     * 
+     * Every move keeps the tree well-formed by construction (swaps exchange
+     * node payloads, the other moves rebuild from traversals), so production
+     * builds only assert the O(1) invariants. Checked builds (make CHECKED=1)
+     * run the full validateTreeStructure() with its cycle, reachability and
+     * module map checks.
      */
-    void clearContour() {
-        while (contourHead != nullptr) {
-            ContourPoint* temp = contourHead;
-            contourHead = contourHead->next;
-            delete temp;
-        }
-        contourHead = nullptr;
+    bool checkTreeStructure(BStarNode* node) {
+#ifdef HW4_CHECKED
+        return validateTreeStructure(node);
+#else
+        assert(node != nullptr || representativeModules.empty());
+        assert(node == nullptr || (node->id >= 0 && static_cast<size_t>(node->id) < geometry.size()));
+        (void)node;
+        return true;
+#endif
     }
     
-    /**
-     * Updates the contour after placing a module
-     */
-    void updateContour(int x, int y, int width, int height);
-    
     /**
      * Gets the height of the contour at a given x-coordinate
      */
     int getContourHeight(int x) {
-        if (contourHead == nullptr) return 0;
-        
-        ContourPoint* curr = contourHead;
-        
-        // Find the last point with x <= target x
-        while (curr->next != nullptr && curr->next->x <= x) {
-            curr = curr->next;
-        }
-        
-        return curr->height;
+        return contour.heightAt(x);
     }
     
     /**
      * Checks if a module is self-symmetric
      */
-    bool isSelfSymmetric(const std::string& moduleName) const {
-        return std::find(selfSymmetricModules.begin(), selfSymmetricModules.end(), moduleName) != selfSymmetricModules.end();
+    bool isSelfSymmetric(ModuleId module) const {
+        return std::find(selfSymmetricModules.begin(), selfSymmetricModules.end(), module) != selfSymmetricModules.end();
     }
 
     /**
      * Checks if a module is a representative (not a symmetric module)
      */
-    bool isRepresentative(const std::string& moduleName) const {
-        return representativeModules.find(moduleName) != representativeModules.end();
+    bool isRepresentative(ModuleId module) const {
+        return representativeModules.find(module) != representativeModules.end();
     }
     
     /**
@@ -370,9 +516,30 @@ public:
      */
     void updateSymmetricModulePositions();
     
+    /**
+     * Gathers the current pair and self-symmetric geometry into pairLanes
+     */
+    void gatherPairLanes() const;
+    
+    /**
+     * Rotates self-symmetric modules so their lengths along the symmetry
+     * direction share one parity; an axis can only center all of them then
+     */
+    void alignSelfSymmetricParity();
+    
+    /**
+     * Stacks self-symmetric modules along the axis so that no two of them
+     * share a row (column for horizontal symmetry); they all straddle the
+     * axis, so sharing one would make them overlap once centered
+     */
+    void separateSelfSymmetricModules();
+    
     /**
      * Calculates the position of the symmetry axis based on the current placement
      * Using the method described in the paper
+     * 
+     * The axis is kept far enough out that every centered self-symmetric
+     * module clears the representatives in its rows.
      */
     void calculateSymmetryAxisPosition();
     
@@ -385,6 +552,22 @@ public:
 
     bool validateSymmetry() const;
 
+    /**
+     * Checks a layout that was placed without packing (e.g. taken from the
+     * island library) for symmetry and overlaps, as pack() does for its own
+     * 
+     * @return True if the current module positions form a legal island
+     */
+    bool validatePlacement();
+
+    /**
+     * Checks that no two modules of the island overlap, reading the positions
+     * from the Module objects so it also holds after the island was placed
+     * 
+     * @return True if the island's modules are pairwise disjoint
+     */
+    bool validateNoOverlaps();
+
     bool validateConnectivity();
 
     bool hasContourOverlap(int x, int y, int width, int height);
@@ -402,7 +585,7 @@ public:
         // Populate the backup traversals
         std::function<void(BStarNode*)> preorderBackup = [&](BStarNode* node) {
             if (node == nullptr) return;
-            treeBackup.preorderTraversal.push_back(node->moduleName);
+            treeBackup.preorderTraversal.push_back(node->id);
             preorderBackup(node->left);
             preorderBackup(node->right);
         };
@@ -410,7 +593,7 @@ public:
         std::function<void(BStarNode*)> inorderBackup = [&](BStarNode* node) {
             if (node == nullptr) return;
             inorderBackup(node->left);
-            treeBackup.inorderTraversal.push_back(node->moduleName);
+            treeBackup.inorderTraversal.push_back(node->id);
             inorderBackup(node->right);
         };
         
@@ -429,16 +612,16 @@ public:
         cleanupTree(root);
         root = nullptr;
         
-        // Create nodes for all modules
-        std::unordered_map<std::string, BStarNode*> nodeMap;
-        for (const std::string& name : treeBackup.preorderTraversal) {
-            if (nodeMap.find(name) == nodeMap.end()) {
-                nodeMap[name] = new BStarNode(name);
+        // Create nodes for all modules, indexed by local id
+        std::vector<BStarNode*> nodeMap(geometry.size(), nullptr);
+        for (int id : treeBackup.preorderTraversal) {
+            if (nodeMap[id] == nullptr) {
+                nodeMap[id] = new BStarNode(geometry.modules[id], id);
             }
         }
         
-        // Create mapping from module name to inorder index
-        std::unordered_map<std::string, size_t> inorderMap;
+        // Create mapping from local id to inorder index
+        std::vector<size_t> inorderMap(geometry.size(), 0);
         for (size_t i = 0; i < treeBackup.inorderTraversal.size(); i++) {
             inorderMap[treeBackup.inorderTraversal[i]] = i;
         }
@@ -451,8 +634,8 @@ public:
                 }
                 
                 // Get the root of current subtree from preorder traversal
-                std::string moduleName = treeBackup.preorderTraversal[preIdx++];
-                BStarNode* node = nodeMap[moduleName];
+                int id = treeBackup.preorderTraversal[preIdx++];
+                BStarNode* node = nodeMap[id];
                 
                 // If this is the only element in this subtree
                 if (inStart == inEnd) {
@@ -460,7 +643,7 @@ public:
                 }
                 
                 // Find the index of current node in inorder traversal
-                size_t inIndex = inorderMap[moduleName];
+                size_t inIndex = inorderMap[id];
                 
                 // Recursively build left and right subtrees
                 if (inIndex > inStart) {
@@ -478,7 +661,7 @@ public:
         root = rebuildTree(preIdx, 0, treeBackup.inorderTraversal.size() - 1);
         
         // Validate the restored structure
-        if (!validateTreeStructure(root)) {
+        if (!checkTreeStructure(root)) {
             throw std::runtime_error("Invalid tree structure after restoration");
         }
     }
@@ -495,9 +678,18 @@ public:
      */
     void setSymmetryAxisPosition(double position) {
         symmetryAxisPosition = position;
+        symmetryAxis2 = static_cast<int>(std::lround(2.0 * position));
         symmetryGroup->setAxisPosition(position);
     }
     
+    /**
+     * Checks whether the last pack could center every self-symmetric module
+     * exactly; if not, they are within half a unit of the axis
+     */
+    bool hasExactSymmetry() const {
+        return exactSymmetryPossible;
+    }
+    
     /**
      * Gets the symmetry group
      */
@@ -508,7 +700,7 @@ public:
     /**
      * Gets all modules in the symmetry group
      */
-    const std::map<std::string, std::shared_ptr<Module>>& getModules() const {
+    const std::map<ModuleId, std::shared_ptr<Module>>& getModules() const {
         return modules;
     }
     
@@ -535,9 +727,9 @@ public:
     /**
      * Gets the area of the symmetry island
      */
-    int getArea() const {
+    Area getArea() const {
         auto [width, height] = getBoundingBox();
-        return width * height;
+        return areaOf(width, height);
     }
     
     /**
@@ -570,27 +762,24 @@ public:
     /**
      * Rotates a specific module and its symmetric pair
      */
-    void rotateModule(const std::string& moduleName) {
+    void rotateModule(ModuleId module) {
         // Check if the module is in this symmetry group
-        if (modules.find(moduleName) == modules.end()) {
+        if (modules.find(module) == modules.end()) {
             return;
         }
         
-        Logger::log("Rotating module " + moduleName);
-        
-        // Get the module to rotate
-        std::shared_ptr<Module> module = modules[moduleName];
+        Logger::log("Rotating module " + moduleName(module));
         
         // Rotate the module
-        module->rotate();
+        modules[module]->rotate();
         
         // If it's part of a symmetry pair, rotate the other module too
-        if (repToPairMap.find(moduleName) != repToPairMap.end()) {
-            modules[repToPairMap[moduleName]]->rotate();
-            Logger::log("Also rotating symmetric pair: " + repToPairMap[moduleName]);
-        } else if (pairMap.find(moduleName) != pairMap.end()) {
-            modules[pairMap[moduleName]]->rotate();
-            Logger::log("Also rotating symmetric pair: " + pairMap[moduleName]);
+        if (repToPairMap.find(module) != repToPairMap.end()) {
+            modules[repToPairMap[module]]->rotate();
+            Logger::log("Also rotating symmetric pair: " + moduleName(repToPairMap[module]));
+        } else if (pairMap.find(module) != pairMap.end()) {
+            modules[pairMap[module]]->rotate();
+            Logger::log("Also rotating symmetric pair: " + moduleName(pairMap[module]));
         }
         
         // Rebuild the B*-tree to adjust to new dimensions
@@ -604,21 +793,21 @@ public:
      * Changes the representative module for a symmetry pair
      * Following the paper's definition and requirements
      */
-    bool changeRepresentative(const std::string& moduleName) {
+    bool changeRepresentative(ModuleId module) {
         // Check if the module is in this symmetry group
-        if (modules.find(moduleName) == modules.end()) {
+        if (modules.find(module) == modules.end()) {
             return false;
         }
         
-        Logger::log("Attempting to change representative for " + moduleName);
+        Logger::log("Attempting to change representative for " + moduleName(module));
         
         // Check if it's part of a symmetry pair
-        if (repToPairMap.find(moduleName) != repToPairMap.end()) {
+        if (repToPairMap.find(module) != repToPairMap.end()) {
             // Current rep -> non-rep
-            std::string rep = moduleName;
-            std::string nonRep = repToPairMap[rep];
+            ModuleId rep = module;
+            ModuleId nonRep = repToPairMap[rep];
             
-            Logger::log("Changing representative from " + rep + " to " + nonRep);
+            Logger::log("Changing representative from " + moduleName(rep) + " to " + moduleName(nonRep));
             
             // Backup the tree structure
             backupTreeStructure();
@@ -626,6 +815,8 @@ public:
             // Swap the representative
             representativeModules.erase(rep);
             representativeModules[nonRep] = modules[nonRep];
+            setRepresentativeFlag(rep, false);
+            setRepresentativeFlag(nonRep, true);
             
             repToPairMap.erase(rep);
             repToPairMap[nonRep] = rep;
@@ -645,6 +836,8 @@ public:
                 // Revert the change
                 representativeModules.erase(nonRep);
                 representativeModules[rep] = modules[rep];
+                setRepresentativeFlag(nonRep, false);
+                setRepresentativeFlag(rep, true);
                 
                 repToPairMap.erase(nonRep);
                 repToPairMap[rep] = nonRep;
@@ -662,12 +855,12 @@ public:
             pack();
             
             return true;
-        } else if (pairMap.find(moduleName) != pairMap.end()) {
+        } else if (pairMap.find(module) != pairMap.end()) {
             // Current non-rep -> rep
-            std::string nonRep = moduleName;
-            std::string rep = pairMap[nonRep];
+            ModuleId nonRep = module;
+            ModuleId rep = pairMap[nonRep];
             
-            Logger::log("Changing representative from " + rep + " to " + nonRep);
+            Logger::log("Changing representative from " + moduleName(rep) + " to " + moduleName(nonRep));
             
             // Backup the tree structure
             backupTreeStructure();
@@ -675,6 +868,8 @@ public:
             // Swap the representative
             representativeModules.erase(rep);
             representativeModules[nonRep] = modules[nonRep];
+            setRepresentativeFlag(rep, false);
+            setRepresentativeFlag(nonRep, true);
             
             repToPairMap.erase(rep);
             repToPairMap[nonRep] = rep;
@@ -694,6 +889,8 @@ public:
                 // Revert the change
                 representativeModules.erase(nonRep);
                 representativeModules[rep] = modules[rep];
+                setRepresentativeFlag(nonRep, false);
+                setRepresentativeFlag(rep, true);
                 
                 repToPairMap.erase(nonRep);
                 repToPairMap[rep] = nonRep;
@@ -714,7 +911,7 @@ public:
         }
         
         // Not part of a symmetry pair
-        Logger::log("Module " + moduleName + " is not part of a symmetry pair");
+        Logger::log("Module " + moduleName(module) + " is not part of a symmetry pair");
         return false;
     }
     
@@ -798,23 +995,23 @@ public:
                 case 0: // Rotate
                     {
                         // Rotate a random module (avoid self-symmetric if possible)
-                        std::vector<std::string> moduleNames;
+                        std::vector<ModuleId> candidates;
                         for (const auto& pair : modules) {
                             if (!isSelfSymmetric(pair.first)) {
-                                moduleNames.push_back(pair.first);
+                                candidates.push_back(pair.first);
                             }
                         }
                         
                         // If no non-self-symmetric modules, include all modules
-                        if (moduleNames.empty()) {
+                        if (candidates.empty()) {
                             for (const auto& pair : modules) {
-                                moduleNames.push_back(pair.first);
+                                candidates.push_back(pair.first);
                             }
                         }
                         
-                        if (!moduleNames.empty()) {
-                            std::string randomModule = moduleNames[std::rand() % moduleNames.size()];
-                            Logger::log("Rotating module " + randomModule);
+                        if (!candidates.empty()) {
+                            ModuleId randomModule = candidates[std::rand() % candidates.size()];
+                            Logger::log("Rotating module " + moduleName(randomModule));
                             rotateModule(randomModule);
                             success = true;
                         }
@@ -826,7 +1023,7 @@ public:
                         Logger::log("Rebuilding tree with different topology");
                         
                         // Ensure we don't lose the original representatives
-                        std::map<std::string, std::shared_ptr<Module>> originalReps = representativeModules;
+                        std::map<ModuleId, std::shared_ptr<Module>> originalReps = representativeModules;
                         
                         // Just rebuild the tree randomly
                         buildInitialBStarTree();
@@ -846,7 +1043,7 @@ public:
                 case 2: // Swap two nodes in the tree
                     {
                         // Get all non-self-symmetric representative modules
-                        std::vector<std::string> repModules;
+                        std::vector<ModuleId> repModules;
                         for (const auto& pair : representativeModules) {
                             if (!isSelfSymmetric(pair.first)) {
                                 repModules.push_back(pair.first);
@@ -862,7 +1059,7 @@ public:
                                 idx2 = std::rand() % repModules.size();
                             } while (idx1 == idx2);
                             
-                            Logger::log("Swapping " + repModules[idx1] + " and " + repModules[idx2]);
+                            Logger::log("Swapping " + moduleName(repModules[idx1]) + " and " + moduleName(repModules[idx2]));
                             
                             // Locate the nodes in the B*-tree
                             BStarNode* node1 = nullptr;
@@ -871,9 +1068,9 @@ public:
                             std::function<void(BStarNode*)> findNodes = [&](BStarNode* node) {
                                 if (node == nullptr) return;
                                 
-                                if (node->moduleName == repModules[idx1]) {
+                                if (node->module == repModules[idx1]) {
                                     node1 = node;
-                                } else if (node->moduleName == repModules[idx2]) {
+                                } else if (node->module == repModules[idx2]) {
                                     node2 = node;
                                 }
                                 
@@ -884,7 +1081,7 @@ public:
                             findNodes(root);
                             
                             if (node1 != nullptr && node2 != nullptr) {
-                                Logger::log("Found both nodes, swapping module names");
+                                Logger::log("Found both nodes, swapping modules");
                                 
                                 // Check if either node is on the critical boundary path
                                 bool node1OnCriticalPath = false;
@@ -923,23 +1120,25 @@ public:
                                 // Reject swap if only one node is on critical path 
                                 // and it's a self-symmetric module
                                 if ((node1OnCriticalPath && !node2OnCriticalPath && 
-                                     isSelfSymmetric(node1->moduleName)) ||
+                                     isSelfSymmetric(node1->module)) ||
                                     (node2OnCriticalPath && !node1OnCriticalPath && 
-                                     isSelfSymmetric(node2->moduleName))) {
+                                     isSelfSymmetric(node2->module))) {
                                     Logger::log("Cannot swap - would violate Property 1 for self-symmetric modules");
                                     return false;
                                 }
                                 
-                                // Swap the module names
-                                std::swap(node1->moduleName, node2->moduleName);
+                                // Swap the modules
+                                std::swap(node1->module, node2->module);
+                                std::swap(node1->id, node2->id);
                                 
                                 // Re-pack to update positions
                                 Logger::log("Re-packing after swap");
                                 success = pack();
                                 
-                                // If packing failed, restore the original node names
+                                // If packing failed, restore the original node modules
                                 if (!success) {
-                                    std::swap(node1->moduleName, node2->moduleName);
+                                    std::swap(node1->module, node2->module);
+                                    std::swap(node1->id, node2->id);
                                     // Restore the original tree structure
                                     restoreTreeStructure();
                                 }
@@ -953,15 +1152,15 @@ public:
                 case 3: // Change representative
                     {
                         // Get all symmetry pairs
-                        std::vector<std::string> symPairs;
+                        std::vector<ModuleId> symPairs;
                         for (const auto& pair : repToPairMap) {
                             symPairs.push_back(pair.first);
                         }
                         
                         if (!symPairs.empty()) {
                             // Select a random symmetry pair
-                            std::string randomRep = symPairs[std::rand() % symPairs.size()];
-                            Logger::log("Changing representative for " + randomRep);
+                            ModuleId randomRep = symPairs[std::rand() % symPairs.size()];
+                            Logger::log("Changing representative for " + moduleName(randomRep));
                             success = changeRepresentative(randomRep);
                         }
                     }
@@ -986,7 +1185,7 @@ public:
         // Validate tree structure after perturbation
         if (success) {
             Logger::log("Validating tree structure after perturbation");
-            if (!validateTreeStructure(root)) {
+            if (!checkTreeStructure(root)) {
                 Logger::log("Invalid tree structure after perturbation, restoring");
                 restoreTreeStructure();
                 success = false;
@@ -0,0 +1,36 @@
+// AnnealingSchedule.cpp
+
+#include "AnnealingSchedule.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+AnnealingSchedule::AnnealingSchedule(double budget, double initialAcceptance, double finalRatio)
+    : budget(budget), initialAcceptance(initialAcceptance), finalRatio(finalRatio),
+      uphillSum(0.0), uphillCount(0), initialTemperature(1.0), temperature(1.0), elapsed(0.0),
+      startTime(std::chrono::steady_clock::now()) {
+}
+
+void AnnealingSchedule::sample(double delta) {
+    if (delta > 0.0) {
+        uphillSum += delta;
+        uphillCount++;
+    }
+}
+
+void AnnealingSchedule::calibrate() {
+    double averageUphill = uphillCount > 0 ? uphillSum / uphillCount : 1.0;
+    initialTemperature = -averageUphill / std::log(initialAcceptance);
+    temperature = initialTemperature;
+}
+
+bool AnnealingSchedule::update() {
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (elapsed >= budget) return false;
+    temperature = initialTemperature * std::pow(finalRatio, elapsed / budget);
+    return true;
+}
+
+bool AnnealingSchedule::accept(double delta) const {
+    return delta <= 0 || static_cast<double>(std::rand()) / RAND_MAX < std::exp(-delta / temperature);
+}
@@ -0,0 +1,69 @@
+// AnnealingSchedule.hpp
+#pragma once
+
+#include <chrono>
+
+/**
+ * @brief Calibrated, time-budgeted temperature schedule for the annealers
+ *
+ * The initial temperature is derived from the design, not hard-coded: the
+ * annealer feeds the cost deltas of a few random moves to sample(), and
+ * calibrate() picks the temperature at which an average uphill move is
+ * accepted with the target probability. The schedule then cools
+ * geometrically in wall-clock time,
+ *
+ *     T(t) = T0 * finalRatio ^ (t / budget)
+ *
+ * reaching finalRatio * T0 exactly when the budget runs out, whatever the
+ * number of moves per second. Since T0 scales with the cost deltas, the same
+ * settings work for small and large designs.
+ */
+class AnnealingSchedule {
+public:
+    /**
+     * @param budget Wall-clock seconds for the whole schedule
+     * @param initialAcceptance Acceptance probability of an average uphill move at the start
+     * @param finalRatio Final temperature relative to the initial one
+     */
+    AnnealingSchedule(double budget, double initialAcceptance = 0.9, double finalRatio = 1e-4);
+
+    // Records the cost delta of a random calibration move
+    void sample(double delta);
+
+    /**
+     * Sets the initial temperature from the samples
+     *
+     * The clock runs from construction, so calibration time counts against
+     * the budget. Without any uphill sample, an average uphill delta of 1 is
+     * assumed, giving -1 / ln(initialAcceptance) (about 9.5 at 0.9).
+     */
+    void calibrate();
+
+    /**
+     * Advances the temperature to the elapsed time
+     *
+     * @return False once the budget is spent
+     */
+    bool update();
+
+    // Whether a move with this cost delta is accepted at the current temperature
+    bool accept(double delta) const;
+
+    double getTemperature() const { return temperature; }
+    double getInitialTemperature() const { return initialTemperature; }
+    double getElapsed() const { return elapsed; }
+    double getBudget() const { return budget; }
+
+private:
+    double budget;
+    double initialAcceptance;
+    double finalRatio;
+
+    double uphillSum;
+    int uphillCount;
+
+    double initialTemperature;
+    double temperature;
+    double elapsed;
+    std::chrono::steady_clock::time_point startTime;
+};
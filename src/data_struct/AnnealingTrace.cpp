@@ -0,0 +1,78 @@
+// AnnealingTrace.cpp
+
+#include "AnnealingTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+std::FILE* traceFile = nullptr;
+std::string buffer;  // Records not yet written
+
+const size_t FLUSH_SIZE = 1 << 16;
+
+double stepLength(const AnnealingSchedule& schedule) {
+    return std::max(schedule.getBudget() / AnnealingTrace::STEPS_PER_RUN, 1e-6);
+}
+
+void flushBuffer() {
+    if (traceFile && !buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), traceFile);
+        buffer.clear();
+    }
+}
+
+} // namespace
+
+bool AnnealingTrace::open(const std::string& path) {
+    close();
+    traceFile = std::fopen(path.c_str(), "w");
+    if (!traceFile) return false;
+    buffer.reserve(FLUSH_SIZE + 256);
+    buffer = "engine,start,step,elapsed,temperature,tried,accepted,uphill,rejected,cost,best,root_shapes\n";
+    return true;
+}
+
+void AnnealingTrace::close() {
+    if (!traceFile) return;
+    flushBuffer();
+    std::fclose(traceFile);
+    traceFile = nullptr;
+}
+
+bool AnnealingTrace::isOpen() {
+    return traceFile != nullptr;
+}
+
+AnnealingTrace::AnnealingTrace(const char* engine, int start, const AnnealingSchedule& schedule)
+    : engine(engine), start(start), schedule(schedule), active(isOpen()),
+      step(0), nextStepTime(stepLength(schedule)),
+      tried(0), accepted(0), uphill(0), rejected(0),
+      lastCost(0.0), lastBest(0.0), lastRootShapes(0) {
+}
+
+AnnealingTrace::~AnnealingTrace() {
+    if (active && tried > 0) flushStep();
+}
+
+void AnnealingTrace::flushStep() {
+    if (!traceFile) return;
+
+    // Steps without moves (spent calibrating, or inside one slow move) are skipped
+    if (tried > 0) {
+        char record[256];
+        int length = std::snprintf(record, sizeof(record), "%s,%d,%d,%.4f,%.6g,%lld,%lld,%lld,%lld,%.17g,%.17g,%zu\n",
+            engine, start, step, schedule.getElapsed(), schedule.getTemperature(),
+            tried, accepted, uphill, rejected, lastCost, lastBest, lastRootShapes);
+        if (length > 0) buffer.append(record, std::min<size_t>(length, sizeof(record) - 1));
+        if (buffer.size() >= FLUSH_SIZE) flushBuffer();
+    }
+
+    // The next record covers the step the schedule is in now
+    while (nextStepTime <= schedule.getElapsed()) {
+        nextStepTime += stepLength(schedule);
+        step++;
+    }
+    tried = accepted = uphill = rejected = 0;
+}
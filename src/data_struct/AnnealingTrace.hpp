@@ -0,0 +1,105 @@
+// AnnealingTrace.hpp
+#pragma once
+
+#include "AnnealingSchedule.hpp"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Per-temperature-step convergence records of an annealing run
+ *
+ * The schedules cool continuously in wall-clock time, so a temperature step
+ * is a fixed slice of a run's budget: every run is cut into STEPS_PER_RUN
+ * steps (the temperature falls by the same factor in each), and one CSV
+ * record sums the moves of a step (steps without moves are left out):
+ *
+ *     engine,start,step,elapsed,temperature,tried,accepted,uphill,rejected,cost,best,root_shapes
+ *
+ * `start` tells the runs of one engine apart (the slicing annealer's
+ * multi-start attempts, the multilevel annealer's levels). `uphill` counts
+ * accepted moves that made the cost worse, `rejected` includes moves that
+ * could not be applied, and `root_shapes` is the number of shape records at
+ * the root of the slicing tree (0 for other engines).
+ *
+ * Tracing is off unless open() was called. Records from all runs go to one
+ * buffered file; a recorder that is off only tests a flag per move.
+ */
+class AnnealingTrace {
+public:
+    static const int STEPS_PER_RUN = 100;
+
+    // Starts writing records to path; false if it cannot be opened
+    static bool open(const std::string& path);
+
+    // Flushes and closes the trace file
+    static void close();
+
+    static bool isOpen();
+
+    /**
+     * @param engine Engine name written with every record
+     * @param start Index of this run among the engine's runs
+     * @param schedule Schedule of the run; steps are slices of its budget
+     */
+    AnnealingTrace(const char* engine, int start, const AnnealingSchedule& schedule);
+
+    // Writes the last, partial step
+    ~AnnealingTrace();
+
+    AnnealingTrace(const AnnealingTrace&) = delete;
+    AnnealingTrace& operator=(const AnnealingTrace&) = delete;
+
+    // Counts an evaluated move
+    void move(double delta, bool accepted) {
+        if (!active) return;
+        tried++;
+        if (accepted) {
+            this->accepted++;
+            if (delta > 0) uphill++;
+        } else {
+            rejected++;
+        }
+    }
+
+    // Counts a move that could not be applied
+    void failedMove() {
+        if (!active) return;
+        tried++;
+        rejected++;
+    }
+
+    /**
+     * Writes a record if the schedule has moved past the current step
+     *
+     * Call after the schedule's update(); cheap enough to call every move.
+     */
+    void update(double cost, double best, std::size_t rootShapes = 0) {
+        if (!active) return;
+        lastCost = cost;
+        lastBest = best;
+        lastRootShapes = rootShapes;
+        if (schedule.getElapsed() >= nextStepTime) flushStep();
+    }
+
+private:
+    // Writes the record of the current step and starts the next one
+    void flushStep();
+
+    const char* engine;
+    int start;
+    const AnnealingSchedule& schedule;
+    bool active;
+
+    int step;
+    double nextStepTime;
+    long long tried;
+    long long accepted;
+    long long uphill;
+    long long rejected;
+
+    // Values from the last update()
+    double lastCost;
+    double lastBest;
+    std::size_t lastRootShapes;
+};
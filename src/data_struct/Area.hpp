@@ -0,0 +1,18 @@
+// Area.hpp
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Type of areas and area-based costs
+ *
+ * Coordinates and dimensions stay int, which covers dies far beyond
+ * 100k x 100k units, but the product of two of them does not fit in 32 bits
+ * once a side passes 46341. Every area is therefore computed and kept as
+ * 64 bits; areaOf() widens before multiplying.
+ */
+using Area = std::int64_t;
+
+inline Area areaOf(int width, int height) {
+    return static_cast<Area>(width) * height;
+}
@@ -0,0 +1,98 @@
+// Compactor.cpp
+
+#include "Compactor.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void Compactor::clear() {
+    rects.clear();
+}
+
+void Compactor::addRect(int id, int x, int y, int width, int height) {
+    rects.push_back({id, x, y, width, height});
+}
+
+bool Compactor::compact(int maxRounds) {
+    bool movedAny = false;
+    for (int round = 0; round < maxRounds; round++) {
+        bool moved = compactAxis(true);
+        moved = compactAxis(false) || moved;
+        if (!moved) break;
+        movedAny = true;
+    }
+    return movedAny;
+}
+
+void Compactor::splitProfile(int c) {
+    auto it = std::prev(profile.upper_bound(c));
+    if (it->first != c) {
+        profile.emplace_hint(std::next(it), c, it->second);
+    }
+}
+
+bool Compactor::compactAxis(bool alongX) {
+    size_t n = rects.size();
+    auto lo = [&](int r) { return alongX ? rects[r].x : rects[r].y; };
+    auto length = [&](int r) { return alongX ? rects[r].width : rects[r].height; };
+    auto crossLo = [&](int r) { return alongX ? rects[r].y : rects[r].x; };
+    auto crossHi = [&](int r) { return alongX ? rects[r].y + rects[r].height : rects[r].x + rects[r].width; };
+
+    order.resize(n);
+    for (size_t i = 0; i < n; i++) order[i] = static_cast<int>(i);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return lo(a) != lo(b) ? lo(a) < lo(b) : crossLo(a) < crossLo(b);
+    });
+
+    // Constraint graph: each rect depends on the owners of its cross span
+    profile.clear();
+    profile.emplace(std::numeric_limits<int>::min(), -1);
+    lastSeen.assign(n, -1);
+    predStart.assign(n + 1, 0);
+    preds.clear();
+
+    for (size_t k = 0; k < n; k++) {
+        int r = order[k];
+        int c1 = crossLo(r);
+        int c2 = crossHi(r);
+        predStart[k] = static_cast<int>(preds.size());
+        if (c1 >= c2) continue;
+
+        splitProfile(c1);
+        splitProfile(c2);
+        auto first = profile.find(c1);
+        auto last = profile.find(c2);
+        for (auto it = first; it != last; ++it) {
+            int owner = it->second;
+            if (owner >= 0 && lastSeen[owner] != r) {
+                lastSeen[owner] = r;
+                preds.push_back(owner);
+            }
+        }
+        profile.erase(first, last);
+        profile.emplace(c1, r);
+    }
+    predStart[n] = static_cast<int>(preds.size());
+    edgeCount = preds.size();
+
+    // Longest path from the wall in sweep (= topological) order
+    position.assign(n, 0);
+    bool moved = false;
+    for (size_t k = 0; k < n; k++) {
+        int r = order[k];
+        int coord = 0;
+        for (int e = predStart[k]; e < predStart[k + 1]; e++) {
+            coord = std::max(coord, position[preds[e]] + length(preds[e]));
+        }
+        position[r] = coord;
+    }
+
+    for (size_t r = 0; r < n; r++) {
+        int& current = alongX ? rects[r].x : rects[r].y;
+        if (current != position[r]) {
+            current = position[r];
+            moved = true;
+        }
+    }
+    return moved;
+}
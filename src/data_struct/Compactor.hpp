@@ -0,0 +1,85 @@
+// Compactor.hpp
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+/**
+ * @brief Constraint-graph compaction of a legal rectangle placement
+ *
+ * Each pass builds the constraint graph along one axis and moves every
+ * rectangle to its longest-path coordinate from the wall at 0, which never
+ * increases a coordinate and keeps the placement legal. Passes alternate
+ * between x (left) and y (down) until neither moves anything.
+ *
+ * Edges only join a rectangle to the ones it "sees" across the sweep: the
+ * profile of the sweep line remembers, per stretch of the cross axis, the
+ * last rectangle covering it, and a new rectangle takes edges from the
+ * owners of its span only. Every other constraint follows transitively,
+ * so the graph is the transitive reduction of the pairwise one with O(n)
+ * edges, and the sweep order is already a topological order.
+ *
+ * Rectangles are rigid; callers move whole symmetry islands as one.
+ */
+class Compactor {
+public:
+    Compactor() : edgeCount(0) {}
+
+    /**
+     * Removes all rectangles
+     */
+    void clear();
+
+    /**
+     * Adds a rectangle with lower-left corner (x, y)
+     *
+     * @param id Caller's id for the rectangle
+     */
+    void addRect(int id, int x, int y, int width, int height);
+
+    /**
+     * Compacts left and down alternately until nothing moves
+     *
+     * @param maxRounds Upper bound on x/y rounds
+     * @return True if any rectangle moved
+     */
+    bool compact(int maxRounds = 16);
+
+    size_t size() const { return rects.size(); }
+
+    // Rectangles in the order they were added, with compacted positions
+    int getId(size_t index) const { return rects[index].id; }
+    int getX(size_t index) const { return rects[index].x; }
+    int getY(size_t index) const { return rects[index].y; }
+
+    // Edges in the last constraint graph built
+    size_t getEdgeCount() const { return edgeCount; }
+
+private:
+    struct Rect {
+        int id;
+        int x, y, width, height;
+    };
+
+    std::vector<Rect> rects;
+    std::vector<int> order;        // Rects sorted along the compaction axis
+    std::vector<int> predStart;    // CSR predecessors per position in order
+    std::vector<int> preds;
+    std::vector<int> lastSeen;     // Dedupes owners while collecting edges
+    std::vector<int> position;     // New coordinate per rect
+    std::map<int, int> profile;    // Cross-axis start -> owning rect (-1 none)
+    size_t edgeCount;
+
+    /**
+     * One compaction pass; returns true if a rectangle moved
+     *
+     * @param alongX Compact left (true) or down (false)
+     */
+    bool compactAxis(bool alongX);
+
+    /**
+     * Makes sure a profile segment starts at coordinate c
+     */
+    void splitProfile(int c);
+};
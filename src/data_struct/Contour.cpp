@@ -0,0 +1,145 @@
+// Contour.cpp
+
+#include "Contour.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+void Contour::reset(std::vector<int>& breakpoints) {
+    std::sort(breakpoints.begin(), breakpoints.end());
+    breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+
+    coords.assign(breakpoints.begin(), breakpoints.end());
+    intervals = coords.size() > 1 ? coords.size() - 1 : 0;
+
+    // assign() keeps the capacity, so repeated packs reuse the same storage
+    nodes.assign(std::max<size_t>(intervals * 4, 1), Node{0, 0, NO_RAISE, false});
+}
+
+bool Contour::toIntervals(int x1, int x2, size_t& first, size_t& last) const {
+    if (intervals == 0 || x2 <= coords.front() || x1 >= coords.back() || x1 >= x2) {
+        return false;
+    }
+
+    // First interval containing x1, last interval starting before x2
+    auto lo = std::upper_bound(coords.begin(), coords.end(), x1);
+    first = lo == coords.begin() ? 0 : static_cast<size_t>(lo - coords.begin()) - 1;
+
+    auto hi = std::lower_bound(coords.begin(), coords.end(), x2);
+    last = static_cast<size_t>(hi - coords.begin()) - 1;
+    last = std::min(last, intervals - 1);
+
+    return first <= last;
+}
+
+void Contour::applyAssign(size_t id, int height) {
+    Node& node = nodes[id];
+    node.maxHeight = height;
+    node.assignTag = height;
+    node.hasAssign = true;
+    node.raiseTag = NO_RAISE;
+}
+
+void Contour::applyRaise(size_t id, int height) {
+    Node& node = nodes[id];
+    node.maxHeight = std::max(node.maxHeight, height);
+    if (node.hasAssign) {
+        node.assignTag = std::max(node.assignTag, height);
+    } else {
+        node.raiseTag = std::max(node.raiseTag, height);
+    }
+}
+
+void Contour::push(size_t id) {
+    Node& node = nodes[id];
+    if (node.hasAssign) {
+        applyAssign(id * 2, node.assignTag);
+        applyAssign(id * 2 + 1, node.assignTag);
+        node.hasAssign = false;
+    }
+    if (node.raiseTag != NO_RAISE) {
+        applyRaise(id * 2, node.raiseTag);
+        applyRaise(id * 2 + 1, node.raiseTag);
+        node.raiseTag = NO_RAISE;
+    }
+}
+
+int Contour::query(size_t ql, size_t qr, size_t l, size_t r, size_t id) {
+    if (ql <= l && qr >= r) {
+        return nodes[id].maxHeight;
+    }
+
+    push(id);
+    size_t mid = (l + r) / 2;
+    int result = 0;
+    if (ql <= mid) result = std::max(result, query(ql, qr, l, mid, id * 2));
+    if (qr > mid) result = std::max(result, query(ql, qr, mid + 1, r, id * 2 + 1));
+    return result;
+}
+
+void Contour::update(size_t ql, size_t qr, int height, bool isAssign, size_t l, size_t r, size_t id) {
+    if (ql <= l && qr >= r) {
+        if (isAssign) {
+            applyAssign(id, height);
+        } else {
+            applyRaise(id, height);
+        }
+        return;
+    }
+
+    push(id);
+    size_t mid = (l + r) / 2;
+    if (ql <= mid) update(ql, qr, height, isAssign, l, mid, id * 2);
+    if (qr > mid) update(ql, qr, height, isAssign, mid + 1, r, id * 2 + 1);
+    nodes[id].maxHeight = std::max(nodes[id * 2].maxHeight, nodes[id * 2 + 1].maxHeight);
+}
+
+int Contour::maxHeight(int x1, int x2) {
+    size_t first, last;
+    if (!toIntervals(x1, x2, first, last)) return 0;
+    return query(first, last, 0, intervals - 1, 1);
+}
+
+void Contour::assign(int x1, int x2, int height) {
+    size_t first, last;
+    if (!toIntervals(x1, x2, first, last)) return;
+    update(first, last, height, true, 0, intervals - 1, 1);
+}
+
+void Contour::raise(int x1, int x2, int height) {
+    size_t first, last;
+    if (!toIntervals(x1, x2, first, last)) return;
+    update(first, last, height, false, 0, intervals - 1, 1);
+}
+
+void Contour::collect(size_t l, size_t r, size_t id, std::vector<int>& heights) {
+    if (l == r) {
+        heights[l] = nodes[id].maxHeight;
+        return;
+    }
+
+    push(id);
+    size_t mid = (l + r) / 2;
+    collect(l, mid, id * 2, heights);
+    collect(mid + 1, r, id * 2 + 1, heights);
+}
+
+std::string Contour::toString() {
+    std::stringstream ss;
+    if (intervals == 0) return "";
+
+    std::vector<int> heights(intervals);
+    collect(0, intervals - 1, 1, heights);
+
+    // Only report points where the height changes
+    int previous = -1;
+    for (size_t i = 0; i < intervals; i++) {
+        if (heights[i] != previous) {
+            ss << "(" << coords[i] << "," << heights[i] << ") ";
+            previous = heights[i];
+        }
+    }
+    ss << "(" << coords.back() << ",0)";
+
+    return ss.str();
+}
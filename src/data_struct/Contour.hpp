@@ -0,0 +1,85 @@
+// Contour.hpp
+#pragma once
+
+#include <vector>
+#include <string>
+#include <limits>
+
+/**
+ * @brief Skyline contour for B*-tree packing
+ *
+ * The x-axis is compressed to the breakpoints handed to reset() (every module
+ * edge of the coming pack), and a lazy segment tree over the elementary
+ * intervals answers range-max queries and applies range-assign / range-raise
+ * updates in O(log n). Storage is kept between packs, so repacking the same
+ * tree does not allocate.
+ *
+ * Shared by the ASF-B*-tree packer and the global B*-tree packer.
+ */
+class Contour {
+public:
+    Contour() : intervals(0) {}
+
+    /**
+     * Prepares an empty (all zero) contour over the given x breakpoints
+     *
+     * @param breakpoints X-coordinates of all module edges; sorted and
+     *                    deduplicated in place
+     */
+    void reset(std::vector<int>& breakpoints);
+
+    /**
+     * Maximum contour height over [x1, x2)
+     */
+    int maxHeight(int x1, int x2);
+
+    /**
+     * Contour height at a single x-coordinate
+     */
+    int heightAt(int x) {
+        return maxHeight(x, x + 1);
+    }
+
+    /**
+     * Sets the contour height over [x1, x2) to height
+     */
+    void assign(int x1, int x2, int height);
+
+    /**
+     * Raises the contour over [x1, x2) to at least height (lower parts are
+     * lifted, higher parts are kept)
+     */
+    void raise(int x1, int x2, int height);
+
+    /**
+     * Returns the contour as "(x,height) ..." breakpoints, for debug logs
+     */
+    std::string toString();
+
+private:
+    static constexpr int NO_RAISE = std::numeric_limits<int>::min();
+
+    struct Node {
+        int maxHeight;   // Max height in the subtree, pending tags included
+        int assignTag;   // Pending assignment (valid if hasAssign)
+        int raiseTag;    // Pending raise (NO_RAISE if none)
+        bool hasAssign;
+    };
+
+    std::vector<int> coords;   // Sorted breakpoints; interval i is [coords[i], coords[i+1])
+    std::vector<Node> nodes;
+    size_t intervals;
+
+    void applyAssign(size_t id, int height);
+    void applyRaise(size_t id, int height);
+    void push(size_t id);
+
+    int query(size_t ql, size_t qr, size_t l, size_t r, size_t id);
+    void update(size_t ql, size_t qr, int height, bool isAssign, size_t l, size_t r, size_t id);
+    void collect(size_t l, size_t r, size_t id, std::vector<int>& heights);
+
+    /**
+     * Maps [x1, x2) to the covered interval indices; returns false if empty
+     */
+    bool toIntervals(int x1, int x2, size_t& first, size_t& last) const;
+};
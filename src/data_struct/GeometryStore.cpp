@@ -0,0 +1,49 @@
+// GeometryStore.cpp
+
+#include "GeometryStore.hpp"
+
+#include <algorithm>
+
+int GeometryStore::add(int width, int height) {
+    int index = static_cast<int>(size());
+    widths.push_back(width);
+    heights.push_back(height);
+    xs.push_back(0);
+    ys.push_back(0);
+    rotated.push_back(0);
+    return index;
+}
+
+void GeometryStore::resize(size_t n) {
+    widths.resize(n, 0);
+    heights.resize(n, 0);
+    xs.resize(n, 0);
+    ys.resize(n, 0);
+    rotated.resize(n, 0);
+}
+
+void GeometryStore::clear() {
+    widths.clear();
+    heights.clear();
+    xs.clear();
+    ys.clear();
+    rotated.clear();
+}
+
+void GeometryStore::setPlacement(const int* x, const int* y, const char* rotations) {
+    std::copy(x, x + size(), xs.begin());
+    std::copy(y, y + size(), ys.begin());
+    std::copy(rotations, rotations + size(), rotated.begin());
+}
+
+void GeometryStore::getExtent(int& right, int& top) const {
+    right = 0;
+    top = 0;
+    for (size_t i = 0; i < size(); i++) {
+        if (widths[i] == 0 && heights[i] == 0) continue;
+        int width = rotated[i] ? heights[i] : widths[i];
+        int height = rotated[i] ? widths[i] : heights[i];
+        right = std::max(right, xs[i] + width);
+        top = std::max(top, ys[i] + height);
+    }
+}
@@ -0,0 +1,105 @@
+// GeometryStore.hpp
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * @brief Allocator returning cache-line aligned storage
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * @brief Structure-of-arrays storage of rectangle geometry
+ *
+ * Entry i is one rectangle: original width and height, lower-left corner
+ * and a rotation flag (rotated rectangles swap width and height). Each field
+ * is its own cache-aligned array, so scans over one field (bounding boxes,
+ * overlap sweeps, snapshots) stream through contiguous memory.
+ *
+ * Module and Block are thin views onto an entry. The parser keeps the
+ * modules in one store indexed by module id; the slicing data keeps its own
+ * store for blocks that are not modules (symmetry islands) and views the
+ * module store for the rest, so the engines write module positions
+ * directly.
+ */
+class GeometryStore {
+public:
+    // Appends a rectangle at the origin, unrotated; returns its index
+    int add(int width, int height);
+
+    // Grows or shrinks to n entries; new entries are empty rectangles
+    void resize(size_t n);
+
+    void clear();
+    size_t size() const { return widths.size(); }
+
+    void setDimensions(int i, int width, int height) {
+        widths[i] = width;
+        heights[i] = height;
+    }
+
+    int getWidth(int i) const { return widths[i]; }
+    int getHeight(int i) const { return heights[i]; }
+    int getX(int i) const { return xs[i]; }
+    int getY(int i) const { return ys[i]; }
+    bool isRotated(int i) const { return rotated[i] != 0; }
+
+    // Dimensions with the rotation applied
+    int getEffectiveWidth(int i) const { return rotated[i] ? heights[i] : widths[i]; }
+    int getEffectiveHeight(int i) const { return rotated[i] ? widths[i] : heights[i]; }
+
+    void setPosition(int i, int x, int y) {
+        xs[i] = x;
+        ys[i] = y;
+    }
+    void setRotated(int i, bool rotate) { rotated[i] = rotate ? 1 : 0; }
+
+    /**
+     * Largest right and top edge over all non-empty entries (0 if none)
+     */
+    void getExtent(int& right, int& top) const;
+
+    // Field arrays, for streaming copies
+    const AlignedVector<int>& getXs() const { return xs; }
+    const AlignedVector<int>& getYs() const { return ys; }
+    const AlignedVector<char>& getRotations() const { return rotated; }
+    
+    // Overwrites every position and rotation; each array holds size() entries
+    void setPlacement(const int* x, const int* y, const char* rotations);
+
+private:
+    AlignedVector<int> widths;
+    AlignedVector<int> heights;
+    AlignedVector<int> xs;
+    AlignedVector<int> ys;
+    AlignedVector<char> rotated;
+};
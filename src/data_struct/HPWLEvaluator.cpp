@@ -0,0 +1,142 @@
+// HPWLEvaluator.cpp
+
+#include "HPWLEvaluator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+void HPWLEvaluator::reset(std::size_t numObjects) {
+    pins.clear();
+    pinNet.clear();
+    netPinStart.assign(1, 0);
+    objectNets.clear();
+    objectNetStart.clear();
+    objects.assign(numObjects, ObjectState{0, 0, false, false});
+    netHpwl2.clear();
+    netDirty.clear();
+    dirtyNets.clear();
+    totalHpwl2 = 0;
+    finalized = false;
+}
+
+int HPWLEvaluator::addNet() {
+    netPinStart.push_back(pins.size());
+    return static_cast<int>(netPinStart.size()) - 2;
+}
+
+void HPWLEvaluator::addPin(int net, int object, int offsetX2, int offsetY2) {
+    // Pins are stored grouped by net, so they may only go to the newest net
+    assert(!finalized && net == static_cast<int>(netPinStart.size()) - 2);
+    assert(object >= 0 && static_cast<std::size_t>(object) < objects.size());
+    (void)net;
+
+    pins.push_back({object, offsetX2, offsetY2});
+    netPinStart.back() = pins.size();
+}
+
+void HPWLEvaluator::finalize() {
+    size_t numNets = getNumNets();
+
+    pinNet.resize(pins.size());
+    for (size_t n = 0; n < numNets; n++) {
+        for (size_t p = netPinStart[n]; p < netPinStart[n + 1]; p++) {
+            pinNet[p] = static_cast<int>(n);
+        }
+    }
+
+    // Count distinct nets per object, then fill (counting sort by object)
+    std::vector<std::pair<int, int>> incidence;
+    incidence.reserve(pins.size());
+    for (size_t p = 0; p < pins.size(); p++) {
+        incidence.push_back({pins[p].object, pinNet[p]});
+    }
+    std::sort(incidence.begin(), incidence.end());
+    incidence.erase(std::unique(incidence.begin(), incidence.end()), incidence.end());
+
+    objectNetStart.assign(objects.size() + 1, 0);
+    for (const auto& entry : incidence) {
+        objectNetStart[entry.first + 1]++;
+    }
+    for (size_t o = 0; o < objects.size(); o++) {
+        objectNetStart[o + 1] += objectNetStart[o];
+    }
+    objectNets.resize(incidence.size());
+    for (size_t i = 0; i < incidence.size(); i++) {
+        objectNets[i] = incidence[i].second;
+    }
+
+    netHpwl2.assign(numNets, 0);
+    netDirty.assign(numNets, 0);
+    dirtyNets.clear();
+    totalHpwl2 = 0;
+    finalized = true;
+}
+
+void HPWLEvaluator::moveObject(int object, int x, int y, bool rotated) {
+    ObjectState& state = objects[object];
+    int x2 = 2 * x;
+    int y2 = 2 * y;
+    if (state.placed && state.x2 == x2 && state.y2 == y2 && state.rotated == rotated) {
+        return;
+    }
+
+    state.x2 = x2;
+    state.y2 = y2;
+    state.rotated = rotated;
+    state.placed = true;
+
+    for (size_t i = objectNetStart[object]; i < objectNetStart[object + 1]; i++) {
+        int net = objectNets[i];
+        if (!netDirty[net]) {
+            netDirty[net] = 1;
+            dirtyNets.push_back(net);
+        }
+    }
+}
+
+long long HPWLEvaluator::computeNet(int net) const {
+    int minX = std::numeric_limits<int>::max();
+    int minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min();
+    int maxY = std::numeric_limits<int>::min();
+    int placedPins = 0;
+
+    for (size_t p = netPinStart[net]; p < netPinStart[net + 1]; p++) {
+        const PinRef& pin = pins[p];
+        const ObjectState& state = objects[pin.object];
+        if (!state.placed) continue;
+
+        int px = state.x2 + (state.rotated ? pin.offsetY2 : pin.offsetX2);
+        int py = state.y2 + (state.rotated ? pin.offsetX2 : pin.offsetY2);
+        minX = std::min(minX, px);
+        maxX = std::max(maxX, px);
+        minY = std::min(minY, py);
+        maxY = std::max(maxY, py);
+        placedPins++;
+    }
+
+    if (placedPins < 2) return 0;
+    return static_cast<long long>(maxX - minX) + (maxY - minY);
+}
+
+double HPWLEvaluator::evaluate() {
+    assert(finalized);
+
+    for (int net : dirtyNets) {
+        long long hpwl2 = computeNet(net);
+        totalHpwl2 += hpwl2 - netHpwl2[net];
+        netHpwl2[net] = hpwl2;
+        netDirty[net] = 0;
+    }
+    dirtyNets.clear();
+
+    return totalHpwl2 / 2.0;
+}
+
+void HPWLEvaluator::getNetObjects(int net, std::vector<int>& netObjects) const {
+    netObjects.clear();
+    for (size_t p = netPinStart[net]; p < netPinStart[net + 1]; p++) {
+        netObjects.push_back(pins[p].object);
+    }
+}
@@ -0,0 +1,105 @@
+// HPWLEvaluator.hpp
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Incremental half-perimeter wirelength of a netlist
+ *
+ * Pins are attached to placement objects (modules, islands or slicing
+ * blocks, whatever the caller indexes). Each object remembers its last
+ * position, and each net keeps its bounding box. Moving an object marks only
+ * the nets on that object as dirty; evaluate() recomputes those boxes and
+ * patches the running total. An unchanged object costs O(1), so syncing all
+ * objects after a perturbation only touches the nets of blocks that moved.
+ *
+ * Coordinates are kept in half-units so pins at block centers stay integral.
+ */
+class HPWLEvaluator {
+public:
+    HPWLEvaluator() : totalHpwl2(0), finalized(false) {}
+
+    /**
+     * Clears the netlist and prepares numObjects unplaced objects
+     */
+    void reset(std::size_t numObjects);
+
+    /**
+     * Starts a new net
+     *
+     * @return Id of the net
+     */
+    int addNet();
+
+    /**
+     * Adds a pin to a net
+     *
+     * @param net Net id from addNet()
+     * @param object Object carrying the pin
+     * @param offsetX2 Doubled x-offset of the pin from the object's lower-left
+     *                 corner, in the object's unrotated frame
+     * @param offsetY2 Doubled y-offset, likewise
+     */
+    void addPin(int net, int object, int offsetX2, int offsetY2);
+
+    /**
+     * Builds the object-to-net incidence; call once after all pins are added
+     */
+    void finalize();
+
+    /**
+     * Records the position of an object
+     *
+     * A rotated object transposes its pin offsets. Nets on the object are
+     * marked dirty only if the position or orientation actually changed.
+     */
+    void moveObject(int object, int x, int y, bool rotated);
+
+    /**
+     * Recomputes the dirty nets
+     *
+     * @return Total half-perimeter wirelength
+     */
+    double evaluate();
+
+    /**
+     * Collects the objects carrying the pins of a net (repeats possible)
+     */
+    void getNetObjects(int net, std::vector<int>& netObjects) const;
+
+    bool empty() const { return netPinStart.size() <= 1; }
+    std::size_t getNumNets() const { return netPinStart.empty() ? 0 : netPinStart.size() - 1; }
+
+private:
+    struct PinRef {
+        int object;
+        int offsetX2;
+        int offsetY2;
+    };
+
+    struct ObjectState {
+        int x2;
+        int y2;
+        bool rotated;
+        bool placed;
+    };
+
+    // Pins of net n are pins[netPinStart[n] .. netPinStart[n + 1])
+    std::vector<PinRef> pins;
+    std::vector<int> pinNet;
+    std::vector<std::size_t> netPinStart;
+
+    // Distinct nets of object o are objectNets[objectNetStart[o] .. objectNetStart[o + 1])
+    std::vector<int> objectNets;
+    std::vector<std::size_t> objectNetStart;
+
+    std::vector<ObjectState> objects;
+    std::vector<long long> netHpwl2;
+    std::vector<char> netDirty;
+    std::vector<int> dirtyNets;
+    long long totalHpwl2;
+    bool finalized;
+
+    long long computeNet(int net) const;
+};
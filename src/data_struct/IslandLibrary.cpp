@@ -0,0 +1,228 @@
+// IslandLibrary.cpp
+
+#include "IslandLibrary.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void hashBytes(uint64_t& hash, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+void hashInt(uint64_t& hash, int value) {
+    hashBytes(hash, &value, sizeof(value));
+}
+
+// Names are length-prefixed so ("ab","c") and ("a","bc") hash differently.
+// The key hashes the name rather than the id, which depends on the input.
+void hashModule(uint64_t& hash, ModuleId id,
+                const std::map<ModuleId, std::shared_ptr<Module>>& modules) {
+    const std::string& name = moduleName(id);
+    hashInt(hash, static_cast<int>(name.size()));
+    hashBytes(hash, name.data(), name.size());
+
+    auto it = modules.find(id);
+    if (it == modules.end()) {
+        hashInt(hash, -1);
+        return;
+    }
+    hashInt(hash, it->second->getOriginalWidth());
+    hashInt(hash, it->second->getOriginalHeight());
+}
+
+bool readEntries(std::istream& in, std::unordered_map<uint64_t, IslandShape>& shapes) {
+    std::string tag;
+    while (in >> tag) {
+        if (tag != "island") return false;
+
+        std::string keyText, typeText;
+        int width, height, axis2;
+        size_t count;
+        if (!(in >> keyText >> typeText >> width >> height >> axis2 >> count)) return false;
+
+        IslandShape shape;
+        shape.type = typeText == "H" ? SymmetryType::HORIZONTAL : SymmetryType::VERTICAL;
+        shape.width = width;
+        shape.height = height;
+        shape.axisPosition = axis2 / 2.0;
+
+        // Read placements one by one, so a corrupt count fails at end of input
+        for (size_t i = 0; i < count; i++) {
+            IslandShape::Placement placement;
+            int rotated;
+            if (!(in >> placement.name >> placement.x >> placement.y >> rotated)) return false;
+            placement.rotated = rotated != 0;
+            shape.placements.push_back(placement);
+        }
+
+        // Keys are written as 16 hex digits; anything else is a corrupt library
+        if (keyText.size() != 16 || keyText.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+            return false;
+        }
+        shapes[std::strtoull(keyText.c_str(), nullptr, 16)] = std::move(shape);
+    }
+    return true;
+}
+
+}
+
+uint64_t IslandLibrary::computeKey(const SymmetryGroup& group,
+                                   const std::map<ModuleId, std::shared_ptr<Module>>& modules) {
+    uint64_t hash = FNV_OFFSET;
+
+    hashInt(hash, group.getType() == SymmetryType::VERTICAL ? 0 : 1);
+
+    hashInt(hash, group.getNumPairs());
+    for (const auto& pair : group.getSymmetryPairs()) {
+        hashModule(hash, pair.first, modules);
+        hashModule(hash, pair.second, modules);
+    }
+
+    hashInt(hash, group.getNumSelfSymmetric());
+    for (ModuleId id : group.getSelfSymmetric()) {
+        hashModule(hash, id, modules);
+    }
+
+    return hash;
+}
+
+bool IslandLibrary::load(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        return true;
+    }
+
+    std::unordered_map<uint64_t, IslandShape> loaded;
+    if (!readEntries(in, loaded)) {
+        return false;
+    }
+
+    shapes = std::move(loaded);
+    dirty = false;
+    return true;
+}
+
+bool IslandLibrary::save(const std::string& filename) {
+    if (!dirty) return true;
+
+    // Merge with entries written by other runs since we loaded; ours win
+    std::unordered_map<uint64_t, IslandShape> merged;
+    {
+        std::ifstream in(filename);
+        if (in.is_open() && !readEntries(in, merged)) {
+            merged.clear();
+        }
+    }
+    for (const auto& entry : shapes) {
+        merged[entry.first] = entry.second;
+    }
+
+    // Write to a temporary file and rename, so concurrent readers never see
+    // a partially written library
+    std::string tempName = filename + ".tmp";
+    {
+        std::ofstream out(tempName);
+        if (!out.is_open()) return false;
+
+        for (const auto& entry : merged) {
+            const IslandShape& shape = entry.second;
+            char key[17];
+            std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(entry.first));
+
+            out << "island " << key << " "
+                << (shape.type == SymmetryType::VERTICAL ? "V" : "H") << " "
+                << shape.width << " " << shape.height << " "
+                << std::lround(2.0 * shape.axisPosition) << " "
+                << shape.placements.size() << "\n";
+
+            for (const auto& placement : shape.placements) {
+                out << placement.name << " " << placement.x << " " << placement.y << " "
+                    << (placement.rotated ? 1 : 0) << "\n";
+            }
+        }
+
+        if (!out.good()) return false;
+    }
+
+    if (std::rename(tempName.c_str(), filename.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        return false;
+    }
+
+    shapes = std::move(merged);
+    dirty = false;
+    return true;
+}
+
+const IslandShape* IslandLibrary::find(uint64_t key) const {
+    auto it = shapes.find(key);
+    return it == shapes.end() ? nullptr : &it->second;
+}
+
+void IslandLibrary::store(uint64_t key, SymmetryType type,
+                          const std::map<ModuleId, std::shared_ptr<Module>>& modules,
+                          double axisPosition) {
+    int minX = std::numeric_limits<int>::max();
+    int minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min();
+    int maxY = std::numeric_limits<int>::min();
+
+    for (const auto& pair : modules) {
+        const auto& module = pair.second;
+        minX = std::min(minX, module->getX());
+        minY = std::min(minY, module->getY());
+        maxX = std::max(maxX, module->getRight());
+        maxY = std::max(maxY, module->getTop());
+    }
+    if (modules.empty()) return;
+
+    IslandShape shape;
+    shape.type = type;
+    shape.width = maxX - minX;
+    shape.height = maxY - minY;
+    shape.axisPosition = axisPosition - (type == SymmetryType::VERTICAL ? minX : minY);
+
+    shape.placements.reserve(modules.size());
+    for (const auto& pair : modules) {
+        const auto& module = pair.second;
+        shape.placements.push_back({module->getName(), module->getX() - minX,
+                                    module->getY() - minY, module->getRotated()});
+    }
+
+    shapes[key] = std::move(shape);
+    dirty = true;
+}
+
+bool IslandLibrary::apply(const IslandShape& shape,
+                          const std::map<ModuleId, std::shared_ptr<Module>>& modules) {
+    if (shape.placements.size() != modules.size()) {
+        return false;
+    }
+    const SymbolTable& symbols = SymbolTable::modules();
+    for (const auto& placement : shape.placements) {
+        if (modules.find(symbols.find(placement.name)) == modules.end()) {
+            return false;
+        }
+    }
+
+    for (const auto& placement : shape.placements) {
+        auto& module = modules.at(symbols.find(placement.name));
+        module->setRotation(placement.rotated);
+        module->setPosition(placement.x, placement.y);
+    }
+    return true;
+}
@@ -0,0 +1,109 @@
+// IslandLibrary.hpp
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Module.hpp"
+#include "SymmetryConstraint.hpp"
+
+/**
+ * @brief Packed layout of one symmetry island
+ *
+ * Module coordinates and the symmetry axis are relative to the lower-left
+ * corner of the island's bounding box.
+ */
+struct IslandShape {
+    struct Placement {
+        std::string name;  // Names, not ids: the library outlives the run
+        int x;
+        int y;
+        bool rotated;
+    };
+
+    SymmetryType type;
+    int width;
+    int height;
+    double axisPosition;
+    std::vector<Placement> placements;
+};
+
+/**
+ * @brief Persistent, content-addressed cache of symmetry island layouts
+ *
+ * An island is identified by a 64-bit FNV-1a hash over its symmetry type, its
+ * symmetry pairs and self-symmetric modules (names and original dimensions,
+ * in declaration order). Two problems that share a symmetry group and its
+ * blocks therefore map to the same entry, and the stored layout can be
+ * applied directly instead of packing the ASF-B*-tree again.
+ *
+ * The library is a plain text file:
+ *
+ *     island <key> <V|H> <width> <height> <axis> <modules>
+ *     <name> <x> <y> <rotated>
+ *     ...
+ */
+class IslandLibrary {
+public:
+    IslandLibrary() : dirty(false) {}
+
+    /**
+     * Computes the cache key of a symmetry group
+     *
+     * @param group Symmetry group
+     * @param modules All modules of the problem
+     * @return Content hash of the group definition and block dimensions
+     */
+    static uint64_t computeKey(const SymmetryGroup& group,
+                               const std::map<ModuleId, std::shared_ptr<Module>>& modules);
+
+    /**
+     * Loads all entries from a library file; a missing file is an empty library
+     *
+     * @return False if the file exists but could not be parsed
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * Writes the library back to disk if entries were added since loading
+     *
+     * @return False if the file could not be written
+     */
+    bool save(const std::string& filename);
+
+    /**
+     * Looks up a layout
+     *
+     * @return The stored shape, or nullptr on a miss
+     */
+    const IslandShape* find(uint64_t key) const;
+
+    /**
+     * Records the current packed layout of an island
+     *
+     * @param key Cache key from computeKey()
+     * @param modules Modules of the island at their packed positions
+     * @param axisPosition Absolute symmetry axis position of the packing
+     */
+    void store(uint64_t key, SymmetryType type,
+               const std::map<ModuleId, std::shared_ptr<Module>>& modules,
+               double axisPosition);
+
+    /**
+     * Places the island's modules according to a stored shape
+     *
+     * @return False if the shape does not cover exactly the given modules
+     */
+    static bool apply(const IslandShape& shape,
+                      const std::map<ModuleId, std::shared_ptr<Module>>& modules);
+
+    size_t size() const { return shapes.size(); }
+
+private:
+    std::unordered_map<uint64_t, IslandShape> shapes;
+    bool dirty;
+};
@@ -5,89 +5,93 @@
 
 
 // Constructors
-Module::Module(const std::string& name, int width, int height)
-    : name(name), width(width), height(height), x(0), y(0), isRotated(false) {
-}
-
-Module::Module(const Module& other)
-    : name(other.name), width(other.width), height(other.height),
-      x(other.x), y(other.y), isRotated(other.isRotated) {
+Module::Module(std::shared_ptr<GeometryStore> geometry, ModuleId id, int width, int height)
+    : geometry(std::move(geometry)), id(id) {
+    if (this->geometry->size() <= id) {
+        this->geometry->resize(id + 1);
+    }
+    this->geometry->setDimensions(id, width, height);
+    this->geometry->setPosition(id, 0, 0);
+    this->geometry->setRotated(id, false);
 }
 
 bool Module::overlaps(const Module& other) const {
     // Check if two modules overlap
-    if (x + getWidth() <= other.x || other.x + other.getWidth() <= x) {
+    if (getX() + getWidth() <= other.getX() || other.getX() + other.getWidth() <= getX()) {
         return false; // No horizontal overlap
     }
-    if (y + getHeight() <= other.y || other.y + other.getHeight() <= y) {
+    if (getY() + getHeight() <= other.getY() || other.getY() + other.getHeight() <= getY()) {
         return false; // No vertical overlap
     }
     return true; // There is overlap
 }
 
 // Getters
+ModuleId Module::getId() const {
+    return id;
+}
+
 const std::string& Module::getName() const {
-    return name;
+    return moduleName(id);
 }
 
 int Module::getWidth() const {
-    return isRotated ? height : width;
+    return geometry->getEffectiveWidth(id);
 }
 
 int Module::getHeight() const {
-    return isRotated ? width : height;
+    return geometry->getEffectiveHeight(id);
 }
 
 int Module::getOriginalWidth() const {
-    return width;
+    return geometry->getWidth(id);
 }
 
 int Module::getOriginalHeight() const {
-    return height;
+    return geometry->getHeight(id);
 }
 
 int Module::getX() const {
-    return x;
+    return geometry->getX(id);
 }
 
 int Module::getY() const {
-    return y;
+    return geometry->getY(id);
 }
 
 bool Module::getRotated() const {
-    return isRotated;
+    return geometry->isRotated(id);
 }
 
 // Setters
 void Module::setPosition(int x, int y) {
-    this->x = x;
-    this->y = y;
+    geometry->setPosition(id, x, y);
 }
 
 void Module::rotate() {
-    isRotated = !isRotated;
+    geometry->setRotated(id, !geometry->isRotated(id));
 }
 
 void Module::setRotation(bool rotate) {
-    isRotated = rotate;
+    geometry->setRotated(id, rotate);
 }
 
 // Utility functions
-int Module::getArea() const {
-    return width * height; // Area doesn't change with rotation
+Area Module::getArea() const {
+    return areaOf(getOriginalWidth(), getOriginalHeight()); // Area doesn't change with rotation
 }
 
 int Module::getRight() const {
-    return x + getWidth();
+    return getX() + getWidth();
 }
 
 int Module::getTop() const {
-    return y + getHeight();
+    return getY() + getHeight();
 }
 
 void Module::print() const {
-    std::cout << "Module: " << name << std::endl;
-    std::cout << "  Position: (" << x << ", " << y << ")" << std::endl;
+    std::cout << "Module: " << getName() << std::endl;
+    std::cout << "  Position: (" << getX() << ", " << getY() << ")" << std::endl;
     std::cout << "  Dimensions: " << getWidth() << " x " << getHeight() << std::endl;
-    std::cout << "  Rotated: " << (isRotated ? "Yes" : "No") << std::endl;
-}
\ No newline at end of file
+    std::cout << "  Rotated: " << (getRotated() ? "Yes" : "No") << std::endl;
+}
@@ -3,19 +3,27 @@
 #include <vector>
 #include <memory>
 
+#include "Area.hpp"
+#include "GeometryStore.hpp"
+#include "SymbolTable.hpp"
+
+/**
+ * @brief Hard block of the problem, a view onto its geometry store entry
+ *
+ * Dimensions, position and rotation live in a GeometryStore shared by all
+ * modules of the problem, at index id. Copying a view would alias that
+ * entry, so modules are not copyable.
+ */
 class Module {
 private:
-    std::string name;     // Name of the module/block
-    int width;            // Original width of the module
-    int height;           // Original height of the module
-    int x;                // x-coordinate of the lower-left corner
-    int y;                // y-coordinate of the lower-left corner
-    bool isRotated;       // Rotation status (true for rotated, false for unrotated)
+    std::shared_ptr<GeometryStore> geometry;  // Store holding the module at index id
+    ModuleId id;                              // Interned name of the module/block
     
 public:
     // Constructors
-    Module(const std::string& name, int width, int height);
-    Module(const Module& other); // Copy constructor
+    Module(std::shared_ptr<GeometryStore> geometry, ModuleId id, int width, int height);
+    Module(const Module& other) = delete;
+    Module& operator=(const Module& other) = delete;
 
     /**
      * Checks if this module overlaps with another module
@@ -26,7 +34,9 @@ public:
     bool overlaps(const Module& other) const;
     
     // Getters
-    const std::string& getName() const;
+    ModuleId getId() const;
+    const std::shared_ptr<GeometryStore>& getGeometry() const { return geometry; }
+    const std::string& getName() const;  // Resolved through the module symbol table
     int getWidth() const;        // Returns effective width (accounting for rotation)
     int getHeight() const;       // Returns effective height (accounting for rotation)
     int getOriginalWidth() const; // Returns original width regardless of rotation
@@ -41,7 +51,7 @@ public:
     void setRotation(bool rotate); // Set specific rotation status
     
     // Utility functions
-    int getArea() const;
+    Area getArea() const;
     
     // Boundary points
     int getRight() const; // x + width
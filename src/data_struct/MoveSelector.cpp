@@ -0,0 +1,77 @@
+// MoveSelector.cpp
+
+#include "MoveSelector.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+MoveSelector::MoveSelector(const std::vector<double>& priors)
+    : probabilities(priors), arms(priors.size(), {0.0, 0.0, 0.0, 0}),
+      temperature(0.0), pending(0) {
+
+    double total = 0.0;
+    for (double p : probabilities) total += p;
+    for (double& p : probabilities) {
+        p = total > 0.0 ? p / total : 1.0 / probabilities.size();
+    }
+}
+
+int MoveSelector::select() const {
+    double r = static_cast<double>(std::rand()) / RAND_MAX;
+    int last = size() - 1;
+    for (int move = 0; move < last; move++) {
+        r -= probabilities[move];
+        if (r < 0.0) return move;
+    }
+    return last;
+}
+
+void MoveSelector::record(int move, double delta, bool accepted, double seconds, double temperature) {
+    Arm& arm = arms[move];
+    double improvement = delta < 0.0 ? -delta : 0.0;
+
+    // The first sample seeds the averages so early scores are not biased to 0
+    double rate = arm.uses == 0 ? 1.0 : AVERAGING_RATE;
+    arm.improvement += rate * (improvement - arm.improvement);
+    arm.acceptance += rate * ((accepted && delta != 0.0 ? 1.0 : 0.0) - arm.acceptance);
+    arm.seconds += rate * (seconds - arm.seconds);
+    arm.uses++;
+
+    this->temperature = temperature;
+    if (++pending >= UPDATE_INTERVAL) {
+        updateProbabilities();
+        pending = 0;
+    }
+}
+
+void MoveSelector::updateProbabilities() {
+    int n = size();
+    std::vector<double> score(n, 0.0);
+    double total = 0.0;
+    for (int move = 0; move < n; move++) {
+        const Arm& arm = arms[move];
+        // Keep the priors until every type has been seen
+        if (arm.uses == 0) return;
+        double seconds = arm.seconds > 1e-9 ? arm.seconds : 1e-9;
+        score[move] = (arm.improvement + temperature * arm.acceptance) / seconds;
+        total += score[move];
+    }
+    if (total <= 0.0) return;
+
+    double floor = FLOOR_SHARE / n;
+    for (int move = 0; move < n; move++) {
+        double target = floor + (1.0 - FLOOR_SHARE) * score[move] / total;
+        probabilities[move] += PURSUIT_RATE * (target - probabilities[move]);
+    }
+}
+
+std::string MoveSelector::describe() const {
+    std::string text;
+    char buffer[16];
+    for (int move = 0; move < size(); move++) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f", probabilities[move]);
+        if (move > 0) text += "/";
+        text += buffer;
+    }
+    return text;
+}
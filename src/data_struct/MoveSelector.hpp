@@ -0,0 +1,70 @@
+// MoveSelector.hpp
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Adaptive choice among an annealer's move types (a multi-armed bandit)
+ *
+ * Every move type starts at its prior probability. The annealer reports each
+ * tried move's cost delta, whether it was accepted, and how long it took.
+ * The selector keeps a running average of these per type and scores a type
+ * by
+ *
+ *     (improvement + temperature * acceptance rate) / seconds per move
+ *
+ * where only accepted moves that changed the cost count as accepted. At high
+ * temperature, moves that get accepted at all are worth trying; near the end
+ * only moves that actually lower the cost are. Every UPDATE_INTERVAL reports
+ * the probabilities are pulled toward the scores (adaptive pursuit), with a
+ * floor so that no move type is ever starved.
+ */
+class MoveSelector {
+public:
+    /**
+     * @param priors Initial weight per move type; normalized, need not sum to 1
+     */
+    explicit MoveSelector(const std::vector<double>& priors);
+
+    // Draws a move type with the current probabilities
+    int select() const;
+
+    /**
+     * Reports the outcome of a tried move
+     *
+     * @param move Move type as returned by select()
+     * @param delta Cost change of the move (negative is better)
+     * @param accepted Whether the annealer kept the move
+     * @param seconds Time spent on the move, evaluation included
+     * @param temperature Current annealing temperature
+     */
+    void record(int move, double delta, bool accepted, double seconds, double temperature);
+
+    int size() const { return static_cast<int>(probabilities.size()); }
+    double getProbability(int move) const { return probabilities[move]; }
+
+    // Current probabilities as "p0/p1/...", for logging
+    std::string describe() const;
+
+private:
+    // Running averages per move type
+    struct Arm {
+        double improvement;
+        double acceptance;
+        double seconds;
+        long long uses;
+    };
+
+    static constexpr int UPDATE_INTERVAL = 128;
+    static constexpr double AVERAGING_RATE = 0.02;   // Weight of a new sample
+    static constexpr double PURSUIT_RATE = 0.2;      // Step toward the scores
+    static constexpr double FLOOR_SHARE = 0.2;       // Kept spread evenly over all types
+
+    std::vector<double> probabilities;
+    std::vector<Arm> arms;
+    double temperature;
+    int pending;
+
+    void updateProbabilities();
+};
@@ -0,0 +1,32 @@
+// Net.hpp
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "SymbolTable.hpp"
+
+/**
+ * @brief Pin of a net on a hard block
+ *
+ * The pin sits at the block center shifted by (offsetX, offsetY), given in
+ * the block's unrotated frame; rotating the block transposes the offset.
+ */
+struct Pin {
+    ModuleId module;
+    int offsetX;
+    int offsetY;
+
+    Pin(ModuleId module, int offsetX = 0, int offsetY = 0)
+        : module(module), offsetX(offsetX), offsetY(offsetY) {}
+};
+
+/**
+ * @brief Net connecting pins on one or more hard blocks
+ */
+struct Net {
+    std::string name;
+    std::vector<Pin> pins;
+
+    explicit Net(const std::string& name) : name(name) {}
+};
@@ -0,0 +1,47 @@
+// Outline.hpp
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "Area.hpp"
+
+/**
+ * @brief Fixed outline the placement must fit in, anchored at (0, 0)
+ *
+ * The default outline is unbounded. A packing that sticks out is charged its
+ * area plus PENALTY times the part outside the outline, so the annealers are
+ * pulled back inside while infeasible packings stay comparable.
+ */
+struct Outline {
+    static constexpr Area PENALTY = 10;
+
+    int width;
+    int height;
+
+    Outline() : width(std::numeric_limits<int>::max()), height(std::numeric_limits<int>::max()) {}
+    Outline(int width, int height) : width(width), height(height) {}
+
+    bool isFixed() const {
+        return width != std::numeric_limits<int>::max() || height != std::numeric_limits<int>::max();
+    }
+
+    bool fits(int packedWidth, int packedHeight) const {
+        return packedWidth <= width && packedHeight <= height;
+    }
+
+    /**
+     * Area of a packedWidth x packedHeight packing outside the outline
+     */
+    Area excess(int packedWidth, int packedHeight) const {
+        return areaOf(packedWidth, packedHeight) -
+               areaOf(std::min(packedWidth, width), std::min(packedHeight, height));
+    }
+
+    /**
+     * Area-based cost of a packing: its area, plus the excess PENALTY times
+     */
+    Area cost(int packedWidth, int packedHeight) const {
+        return areaOf(packedWidth, packedHeight) + PENALTY * excess(packedWidth, packedHeight);
+    }
+};
@@ -0,0 +1,104 @@
+// OverlapDetector.cpp
+
+#include "OverlapDetector.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+const int INACTIVE = std::numeric_limits<int>::min();
+}
+
+void OverlapDetector::clear() {
+    rects.clear();
+    overlaps.clear();
+}
+
+void OverlapDetector::addRect(int id, int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0) return;
+    rects.push_back({id, x, y, x + width, y + height});
+}
+
+bool OverlapDetector::hasOverlap() {
+    sweep(true);
+    return !overlaps.empty();
+}
+
+const std::vector<std::pair<int, int>>& OverlapDetector::findOverlaps() {
+    sweep(false);
+    return overlaps;
+}
+
+void OverlapDetector::setLeaf(int rank, int top) {
+    size_t node = leaves + rank;
+    tree[node] = top;
+    for (node /= 2; node >= 1; node /= 2) {
+        tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+    }
+}
+
+bool OverlapDetector::collect(size_t node, size_t lo, size_t hi, int limit, int bottom,
+                              int rect, bool firstOnly) {
+    if (lo >= static_cast<size_t>(limit) || tree[node] <= bottom) return true;
+
+    if (node >= leaves) {
+        overlaps.push_back({rects[rectAtRank[lo]].id, rects[rect].id});
+        return !firstOnly;
+    }
+
+    size_t mid = (lo + hi) / 2;
+    return collect(2 * node, lo, mid, limit, bottom, rect, firstOnly) &&
+           collect(2 * node + 1, mid, hi, limit, bottom, rect, firstOnly);
+}
+
+void OverlapDetector::sweep(bool firstOnly) {
+    overlaps.clear();
+    size_t n = rects.size();
+    if (n < 2) return;
+
+    // Rank rectangles by bottom edge (ties broken by index for unique leaves)
+    rectAtRank.resize(n);
+    for (size_t i = 0; i < n; i++) rectAtRank[i] = static_cast<int>(i);
+    std::sort(rectAtRank.begin(), rectAtRank.end(), [this](int a, int b) {
+        return rects[a].y1 != rects[b].y1 ? rects[a].y1 < rects[b].y1 : a < b;
+    });
+
+    rankOf.resize(n);
+    bottoms.resize(n);
+    for (size_t r = 0; r < n; r++) {
+        rankOf[rectAtRank[r]] = static_cast<int>(r);
+        bottoms[r] = rects[rectAtRank[r]].y1;
+    }
+
+    leaves = 1;
+    while (leaves < n) leaves *= 2;
+    tree.assign(2 * leaves, INACTIVE);
+
+    // Leaving before entering at equal x, so touching edges do not overlap
+    events.clear();
+    events.reserve(2 * n);
+    for (size_t i = 0; i < n; i++) {
+        events.push_back({rects[i].x1, static_cast<int>(i), true});
+        events.push_back({rects[i].x2, static_cast<int>(i), false});
+    }
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        if (a.x != b.x) return a.x < b.x;
+        return a.enter < b.enter;
+    });
+
+    for (const Event& event : events) {
+        const Rect& rect = rects[event.rect];
+        if (!event.enter) {
+            setLeaf(rankOf[event.rect], INACTIVE);
+            continue;
+        }
+
+        // Active rects with bottom < rect.y2 form the rank prefix [0, limit)
+        int limit = static_cast<int>(std::lower_bound(bottoms.begin(), bottoms.end(), rect.y2) - bottoms.begin());
+        if (!collect(1, 0, leaves, limit, rect.y1, event.rect, firstOnly)) {
+            return;
+        }
+
+        setLeaf(rankOf[event.rect], rect.y2);
+    }
+}
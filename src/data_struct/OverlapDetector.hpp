@@ -0,0 +1,86 @@
+// OverlapDetector.hpp
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Sweep-line overlap detection for axis-aligned rectangles
+ *
+ * Rectangles are swept along x. The active set lives in a max segment tree
+ * whose leaves are the rectangles ranked by their bottom edge and hold the
+ * top edge of active rectangles. A rectangle entering the sweep overlaps
+ * exactly the active ones with bottom < its top (a rank prefix) and
+ * top > its bottom (found by descending only into subtrees whose max
+ * exceeds it), so all k overlapping pairs are reported in
+ * O(n log n + k log n) instead of comparing every pair.
+ *
+ * Rectangles that merely touch do not overlap; empty rectangles are ignored.
+ * Storage is reused between runs.
+ */
+class OverlapDetector {
+public:
+    OverlapDetector() : leaves(0) {}
+
+    /**
+     * Removes all rectangles
+     */
+    void clear();
+
+    /**
+     * Adds a rectangle with lower-left corner (x, y)
+     *
+     * @param id Caller's id for the rectangle, reported in overlapping pairs
+     */
+    void addRect(int id, int x, int y, int width, int height);
+
+    /**
+     * Checks whether any two rectangles overlap; stops at the first overlap
+     */
+    bool hasOverlap();
+
+    /**
+     * Finds all overlapping pairs
+     *
+     * @return Pairs of ids (each pair reported once)
+     */
+    const std::vector<std::pair<int, int>>& findOverlaps();
+
+    size_t size() const { return rects.size(); }
+
+private:
+    struct Rect {
+        int id;
+        int x1, y1, x2, y2;
+    };
+
+    struct Event {
+        int x;
+        int rect;
+        bool enter;
+    };
+
+    std::vector<Rect> rects;
+    std::vector<Event> events;
+    std::vector<int> rankOf;      // Rect index -> rank by bottom edge
+    std::vector<int> bottoms;     // Bottom edges in rank order
+    std::vector<int> rectAtRank;  // Rank -> rect index
+    std::vector<int> tree;        // Max top edge of active rects per node
+    size_t leaves;
+    std::vector<std::pair<int, int>> overlaps;
+
+    /**
+     * Runs the sweep; stops after the first overlap if firstOnly
+     */
+    void sweep(bool firstOnly);
+
+    void setLeaf(int rank, int top);
+
+    /**
+     * Reports active rects in ranks [0, limit) whose top exceeds bottom
+     *
+     * @return False once an overlap was found and firstOnly is set
+     */
+    bool collect(size_t node, size_t lo, size_t hi, int limit, int bottom, int rect, bool firstOnly);
+};
@@ -0,0 +1,28 @@
+// SymbolTable.cpp
+
+#include "SymbolTable.hpp"
+
+ModuleId SymbolTable::intern(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+
+    ModuleId id = static_cast<ModuleId>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+ModuleId SymbolTable::find(const std::string& name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? NONE : it->second;
+}
+
+void SymbolTable::clear() {
+    names.clear();
+    ids.clear();
+}
+
+SymbolTable& SymbolTable::modules() {
+    static SymbolTable table;
+    return table;
+}
@@ -0,0 +1,52 @@
+// SymbolTable.hpp
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Dense id of an interned module name
+ *
+ * Ids are handed out in first-seen order starting at 0, so for modules
+ * interned at parse time they follow the input file and can index vectors
+ * directly.
+ */
+using ModuleId = std::uint32_t;
+
+/**
+ * @brief Interning table mapping names to dense ids and back
+ *
+ * Names are stored once; everything past the parser compares, hashes and
+ * stores ids, and only resolves them with name() for logs and output.
+ * References returned by name() stay valid for the table's lifetime.
+ */
+class SymbolTable {
+public:
+    static constexpr ModuleId NONE = std::numeric_limits<ModuleId>::max();
+
+    // Returns the id of name, adding it if it is new
+    ModuleId intern(const std::string& name);
+
+    // Returns the id of name, or NONE if it was never interned
+    ModuleId find(const std::string& name) const;
+
+    const std::string& name(ModuleId id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+
+    void clear();
+
+    // Process-wide table of module names, filled by the parser
+    static SymbolTable& modules();
+
+private:
+    std::deque<std::string> names;  // Id -> name; a deque keeps references stable
+    std::unordered_map<std::string, ModuleId> ids;
+};
+
+// Name of an interned module, for logs and output
+inline const std::string& moduleName(ModuleId id) {
+    return SymbolTable::modules().name(id);
+}
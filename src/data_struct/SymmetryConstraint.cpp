@@ -10,7 +10,7 @@ SymmetryGroup::SymmetryGroup(const string& name, SymmetryType type)
     : name(name), type(type), axisPosition(-1) {}
 
 // Module management functions
-void SymmetryGroup::addSymmetryPair(const string& module1, const string& module2) {
+void SymmetryGroup::addSymmetryPair(ModuleId module1, ModuleId module2) {
     symmetryPairs.push_back(make_pair(module1, module2));
     
     // Update lookup structures for O(1) access
@@ -20,7 +20,7 @@ void SymmetryGroup::addSymmetryPair(const string& module1, const string& module2
     allModules.insert(module2);
 }
 
-void SymmetryGroup::addSelfSymmetric(const string& module) {
+void SymmetryGroup::addSelfSymmetric(ModuleId module) {
     selfSymmetric.push_back(module);
     
     // Update lookup structures for O(1) access
@@ -29,27 +29,27 @@ void SymmetryGroup::addSelfSymmetric(const string& module) {
 }
 
 // Query functions with O(1) complexity
-bool SymmetryGroup::isInGroup(const string& moduleName) const {
-    return allModules.find(moduleName) != allModules.end();
+bool SymmetryGroup::isInGroup(ModuleId module) const {
+    return allModules.find(module) != allModules.end();
 }
 
-bool SymmetryGroup::isSelfSymmetric(const string& moduleName) const {
-    return selfSymSet.find(moduleName) != selfSymSet.end();
+bool SymmetryGroup::isSelfSymmetric(ModuleId module) const {
+    return selfSymSet.find(module) != selfSymSet.end();
 }
 
-bool SymmetryGroup::isSymmetryPair(const string& module1, const string& module2) const {
+bool SymmetryGroup::isSymmetryPair(ModuleId module1, ModuleId module2) const {
     auto it = pairMap.find(module1);
     return (it != pairMap.end() && it->second == module2);
 }
 
-string SymmetryGroup::getSymmetricPair(const string& moduleName) const {
-    auto it = pairMap.find(moduleName);
-    return (it != pairMap.end()) ? it->second : "";
+ModuleId SymmetryGroup::getSymmetricPair(ModuleId module) const {
+    auto it = pairMap.find(module);
+    return (it != pairMap.end()) ? it->second : SymbolTable::NONE;
 }
 
 // Determine if modules form a connected symmetry island
-bool SymmetryGroup::isSymmetryIsland(const unordered_map<string, pair<int, int>>& positions,
-                                    const unordered_map<string, pair<int, int>>& dimensions) const {
+bool SymmetryGroup::isSymmetryIsland(const unordered_map<ModuleId, pair<int, int>>& positions,
+                                    const unordered_map<ModuleId, pair<int, int>>& dimensions) const {
     if (allModules.empty()) return true;
     
     // Check if all modules are present
@@ -61,8 +61,8 @@ bool SymmetryGroup::isSymmetryIsland(const unordered_map<string, pair<int, int>>
     }
     
     // Check connectivity using BFS
-    unordered_set<string> visited;
-    queue<string> queue;
+    unordered_set<ModuleId> visited;
+    queue<ModuleId> queue;
     
     // Start with the first module
     auto it = allModules.begin();
@@ -70,7 +70,7 @@ bool SymmetryGroup::isSymmetryIsland(const unordered_map<string, pair<int, int>>
     visited.insert(*it);
     
     // Helper lambda to check if two modules are adjacent
-    auto isAdjacent = [&](const string& m1, const string& m2) -> bool {
+    auto isAdjacent = [&](ModuleId m1, ModuleId m2) -> bool {
         const auto& pos1 = positions.at(m1);
         const auto& pos2 = positions.at(m2);
         const auto& dim1 = dimensions.at(m1);
@@ -99,7 +99,7 @@ bool SymmetryGroup::isSymmetryIsland(const unordered_map<string, pair<int, int>>
     
     // BFS to check connectivity
     while (!queue.empty()) {
-        string current = queue.front();
+        ModuleId current = queue.front();
         queue.pop();
         
         for (const auto& module : allModules) {
@@ -119,11 +119,11 @@ string SymmetryGroup::getName() const {
     return name;
 }
 
-const vector<pair<string, string>>& SymmetryGroup::getSymmetryPairs() const {
+const vector<pair<ModuleId, ModuleId>>& SymmetryGroup::getSymmetryPairs() const {
     return symmetryPairs;
 }
 
-const vector<string>& SymmetryGroup::getSelfSymmetric() const {
+const vector<ModuleId>& SymmetryGroup::getSelfSymmetric() const {
     return selfSymmetric;
 }
 
@@ -147,7 +147,7 @@ double SymmetryGroup::getAxisPosition() const {
     return axisPosition;
 }
 
-const unordered_set<string>& SymmetryGroup::getAllModules() const {
+const unordered_set<ModuleId>& SymmetryGroup::getAllModules() const {
     return allModules;
 }
 
@@ -167,8 +167,8 @@ void SymmetryGroup::changeSymmetryType() {
 
 // Validation and utility functions
 bool SymmetryGroup::validateSymmetricPlacement(
-    const unordered_map<string, pair<int, int>>& positions,
-    const unordered_map<string, pair<int, int>>& dimensions) const {
+    const unordered_map<ModuleId, pair<int, int>>& positions,
+    const unordered_map<ModuleId, pair<int, int>>& dimensions) const {
     
     // Calculate symmetry axis if not set
     double axis = (axisPosition < 0) ? calculateAxisPosition(positions) : axisPosition;
@@ -244,7 +244,7 @@ bool SymmetryGroup::validateSymmetricPlacement(
     return true;
 }
 
-double SymmetryGroup::calculateAxisPosition(const unordered_map<string, pair<int, int>>& positions) const {
+double SymmetryGroup::calculateAxisPosition(const unordered_map<ModuleId, pair<int, int>>& positions) const {
     if (symmetryPairs.empty() && selfSymmetric.empty()) {
         return -1.0; // No modules to calculate axis
     }
@@ -6,6 +6,7 @@
 #include <unordered_set>
 #include <utility>
 #include <memory>
+#include "SymbolTable.hpp"
 using namespace std;
 
 enum class SymmetryType {
@@ -16,14 +17,14 @@ enum class SymmetryType {
 class SymmetryGroup {
 private:
     string name;                                // Name of the symmetry group
-    vector<pair<string, string>> symmetryPairs;  // Pairs of modules
-    vector<string> selfSymmetric;          // Self-symmetric modules
+    vector<pair<ModuleId, ModuleId>> symmetryPairs;  // Pairs of modules
+    vector<ModuleId> selfSymmetric;          // Self-symmetric modules
     SymmetryType type;                               // Symmetry type (vertical/horizontal)
     
     // Hash table for lookup structures
-    unordered_map<string, string> pairMap;  // For quick symmetry pair lookup
-    unordered_set<string> selfSymSet;            // For quick self-symmetric lookup
-    unordered_set<string> allModules;            // All modules in this group
+    unordered_map<ModuleId, ModuleId> pairMap;  // For quick symmetry pair lookup
+    unordered_set<ModuleId> selfSymSet;            // For quick self-symmetric lookup
+    unordered_set<ModuleId> allModules;            // All modules in this group
     
     // Symmetry axis position - VERTICAL: x; HORIZONTAL: y
     double axisPosition;
@@ -33,29 +34,29 @@ public:
     SymmetryGroup(const string& name, SymmetryType type = SymmetryType::VERTICAL);
     
     // Module management
-    void addSymmetryPair(const string& module1, const string& module2);
-    void addSelfSymmetric(const string& module);
+    void addSymmetryPair(ModuleId module1, ModuleId module2);
+    void addSelfSymmetric(ModuleId module);
     
     // Query functions
-    bool isInGroup(const string& moduleName) const;
-    bool isSelfSymmetric(const string& moduleName) const;
-    bool isSymmetryPair(const string& module1, const string& module2) const;
-    string getSymmetricPair(const string& moduleName) const;
+    bool isInGroup(ModuleId module) const;
+    bool isSelfSymmetric(ModuleId module) const;
+    bool isSymmetryPair(ModuleId module1, ModuleId module2) const;
+    ModuleId getSymmetricPair(ModuleId module) const;  // SymbolTable::NONE if not in a pair
     
     // Symmetry island formation validation
-    bool isSymmetryIsland(const unordered_map<string, pair<int, int>>& positions, 
-                         const unordered_map<string, pair<int, int>>& dimensions) const;
+    bool isSymmetryIsland(const unordered_map<ModuleId, pair<int, int>>& positions, 
+                         const unordered_map<ModuleId, pair<int, int>>& dimensions) const;
     
     // Getters
     string getName() const;
-    const vector<pair<string, string>>& getSymmetryPairs() const;
-    const vector<string>& getSelfSymmetric() const;
+    const vector<pair<ModuleId, ModuleId>>& getSymmetryPairs() const;
+    const vector<ModuleId>& getSelfSymmetric() const;
     SymmetryType getType() const;
     int getNumModules() const;
     int getNumPairs() const;
     int getNumSelfSymmetric() const;
     double getAxisPosition() const;
-    const unordered_set<string>& getAllModules() const;
+    const unordered_set<ModuleId>& getAllModules() const;
     
     // Setters
     void setAxisPosition(double position);
@@ -65,7 +66,7 @@ public:
     void changeSymmetryType();
     
     // Validation and utility functions
-    bool validateSymmetricPlacement(const unordered_map<string, pair<int, int>>& positions,
-                                  const unordered_map<string, pair<int, int>>& dimensions) const;
-    double calculateAxisPosition(const unordered_map<string, pair<int, int>>& positions) const;
+    bool validateSymmetricPlacement(const unordered_map<ModuleId, pair<int, int>>& positions,
+                                  const unordered_map<ModuleId, pair<int, int>>& dimensions) const;
+    double calculateAxisPosition(const unordered_map<ModuleId, pair<int, int>>& positions) const;
 };
\ No newline at end of file
@@ -21,9 +21,10 @@ private:
     int height;  // Height of the bounding rectangle
     int x;       // X-coordinate of the lower-left corner in global placement
     int y;       // Y-coordinate of the lower-left corner in global placement
+    bool fromLibrary;  // Internal layout was taken from the island library
     
     // Cached original positions of modules before global placement
-    std::map<std::string, std::pair<int, int>> originalPositions;
+    std::map<ModuleId, std::pair<int, int>> originalPositions;
     
 public:
     /**
@@ -31,9 +32,13 @@ public:
      * 
      * @param name Name of the symmetry group
      * @param asfTree ASF-B*-tree that manages internal symmetry
+     * @param fromLibrary True if the modules already hold a cached layout,
+     *                    which is then used as-is instead of packing the tree
      */
-    SymmetryIslandBlock(const std::string& name, std::shared_ptr<ASFBStarTree> asfTree)
-        : name(name), asfTree(asfTree), width(0), height(0), x(0), y(0) {
+    SymmetryIslandBlock(const std::string& name, std::shared_ptr<ASFBStarTree> asfTree,
+                        bool fromLibrary = false)
+        : name(name), asfTree(asfTree), width(0), height(0), x(0), y(0),
+          fromLibrary(fromLibrary) {
         updateBoundingBox();
     }
     
@@ -42,7 +47,9 @@ public:
      */
     void updateBoundingBox() {
         // Pack the ASF-B*-tree to get the internal layout
-        asfTree->pack();
+        if (!fromLibrary) {
+            asfTree->pack();
+        }
         
         // Find the bounding rectangle
         int minX = std::numeric_limits<int>::max();
@@ -87,11 +94,10 @@ public:
      */
     void updateModulePositions() {
         for (const auto& pair : asfTree->getModules()) {
-            const auto& moduleName = pair.first;
             auto& module = pair.second;
             
             // Get relative position
-            const auto& relPos = originalPositions[moduleName];
+            const auto& relPos = originalPositions[pair.first];
             
             // Set absolute position
             module->setPosition(x + relPos.first, y + relPos.second);
@@ -115,6 +121,15 @@ public:
     int getY() const { return y; }
     std::string getName() const { return name; }
     std::shared_ptr<ASFBStarTree> getASFBStarTree() const { return asfTree; }
+    bool isFromLibrary() const { return fromLibrary; }
+    
+    /**
+     * Gets the position of a module relative to the island's lower-left corner
+     */
+    std::pair<int, int> getRelativePosition(ModuleId module) const {
+        auto it = originalPositions.find(module);
+        return it == originalPositions.end() ? std::make_pair(0, 0) : it->second;
+    }
     
     // Setters
     void setPosition(int x, int y) {
@@ -156,8 +171,8 @@ public:
     /**
      * Gets the area of the island
      */
-    int getArea() const {
-        return width * height;
+    Area getArea() const {
+        return areaOf(width, height);
     }
     
     /**
@@ -0,0 +1,134 @@
+// SymmetryKernels.cpp
+
+#include "SymmetryKernels.hpp"
+
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace SymmetryKernels {
+
+// Halving rounds towards +infinity on .5 so odd sums land on the same side
+// as the previous std::round based code for non-negative coordinates
+
+void mirrorPairs(std::size_t count, int axis2,
+                 const int* repPos, const int* repLen, const int* repCross,
+                 const int* symLen, int* symPos, int* symCross) {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i twoAxis = _mm256_set1_epi32(2 * axis2 + 1);
+    for (; i + 8 <= count; i += 8) {
+        __m256i rp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repPos + i));
+        __m256i rl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repLen + i));
+        __m256i sl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symLen + i));
+        __m256i rc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repCross + i));
+
+        // symPos = (2 * axis2 + 1 - 2 * repPos - repLen - symLen) >> 1
+        __m256i num = _mm256_sub_epi32(twoAxis, _mm256_add_epi32(rp, rp));
+        num = _mm256_sub_epi32(num, _mm256_add_epi32(rl, sl));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(symPos + i), _mm256_srai_epi32(num, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(symCross + i), rc);
+    }
+#endif
+
+    for (; i < count; i++) {
+        symPos[i] = (2 * axis2 + 1 - 2 * repPos[i] - repLen[i] - symLen[i]) >> 1;
+        symCross[i] = repCross[i];
+    }
+}
+
+void centerSelfSymmetric(std::size_t count, int axis2, const int* len, int* pos) {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i axis = _mm256_set1_epi32(axis2 + 1);
+    for (; i + 8 <= count; i += 8) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(len + i));
+        __m256i p = _mm256_srai_epi32(_mm256_sub_epi32(axis, l), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pos + i), p);
+    }
+#endif
+
+    for (; i < count; i++) {
+        pos[i] = (axis2 + 1 - len[i]) >> 1;
+    }
+}
+
+long findPairViolation(std::size_t count, int axis2, int tolerance2,
+                       const int* repPos, const int* repLen, const int* repCross, const int* repCrossLen,
+                       const int* symPos, const int* symLen, const int* symCross, const int* symCrossLen) {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i twoAxis = _mm256_set1_epi32(2 * axis2);
+    const __m256i tol = _mm256_set1_epi32(tolerance2);
+    for (; i + 8 <= count; i += 8) {
+        __m256i rp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repPos + i));
+        __m256i rl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repLen + i));
+        __m256i sp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symPos + i));
+        __m256i sl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symLen + i));
+        __m256i rc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repCross + i));
+        __m256i rcl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(repCrossLen + i));
+        __m256i sc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symCross + i));
+        __m256i scl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symCrossLen + i));
+
+        // Doubled centers across the axis must sum to 2 * axis2
+        __m256i sum = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(rp, rp), rl),
+                                       _mm256_add_epi32(_mm256_add_epi32(sp, sp), sl));
+        __m256i err = _mm256_abs_epi32(_mm256_sub_epi32(sum, twoAxis));
+
+        // Doubled centers along the axis must coincide
+        __m256i align = _mm256_abs_epi32(_mm256_sub_epi32(
+            _mm256_add_epi32(_mm256_add_epi32(rc, rc), rcl),
+            _mm256_add_epi32(_mm256_add_epi32(sc, sc), scl)));
+
+        __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi32(err, tol), _mm256_cmpgt_epi32(align, tol));
+        if (!_mm256_testz_si256(bad, bad)) {
+            break; // Locate the exact lane with the scalar loop below
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        int sum = 2 * repPos[i] + repLen[i] + 2 * symPos[i] + symLen[i];
+        int align = (2 * repCross[i] + repCrossLen[i]) - (2 * symCross[i] + symCrossLen[i]);
+        if (std::abs(sum - 2 * axis2) > tolerance2 || std::abs(align) > tolerance2) {
+            return static_cast<long>(i);
+        }
+    }
+
+    return -1;
+}
+
+long findSelfSymmetricViolation(std::size_t count, int axis2, int tolerance2,
+                                const int* pos, const int* len) {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i axis = _mm256_set1_epi32(axis2);
+    const __m256i tol = _mm256_set1_epi32(tolerance2);
+    for (; i + 8 <= count; i += 8) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos + i));
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(len + i));
+        __m256i err = _mm256_abs_epi32(_mm256_sub_epi32(_mm256_add_epi32(_mm256_add_epi32(p, p), l), axis));
+        __m256i bad = _mm256_cmpgt_epi32(err, tol);
+        if (!_mm256_testz_si256(bad, bad)) {
+            break;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (std::abs(2 * pos[i] + len[i] - axis2) > tolerance2) {
+            return static_cast<long>(i);
+        }
+    }
+
+    return -1;
+}
+
+}
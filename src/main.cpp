@@ -4,6 +4,7 @@
 #include <ctime>
 #include <cstdlib>
 #include <iomanip>
+#include <vector>
 
 #include "parser/Parser.hpp"
 #include "solver/solver.hpp"
@@ -11,17 +12,27 @@
 #include "data_struct/SymmetryConstraint.hpp"
 #include "data_struct/ASFBStarTree.hpp"
 #include "data_struct/SymmetryIslandBlock.hpp"
+#include "data_struct/AnnealingTrace.hpp"
 #include "Logger.hpp"
+#include "Profiler.hpp"
+#include "ChromeTrace.hpp"
 
 void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " <input_file> <output_file> [area_ratio]" << std::endl;
+    std::cout << "Usage: " << programName << " <input_file> <output_file> [area_ratio] [options]" << std::endl;
     std::cout << "  input_file: Path to the input .txt file" << std::endl;
     std::cout << "  output_file: Path to the output .out file" << std::endl;
     std::cout << "  area_ratio: Optional parameter for area vs. wirelength weight ratio (default 1.0)" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --island-library=<file>: Reuse and record packed symmetry islands in <file>" << std::endl;
+    std::cout << "  --engine=<slicing|seqpair|bstar|multilevel>: Global placement engine (default slicing)" << std::endl;
+    std::cout << "  --outline=<W>x<H>: Fixed-outline mode; pack into a W x H outline at the origin" << std::endl;
+    std::cout << "  --anneal-trace=<file>: Write per-temperature-step annealing records to <file> (CSV)" << std::endl;
+    std::cout << "  --chrome-trace=<file>: Write a timeline of solver phases to <file> (Chrome trace JSON)" << std::endl;
+    std::cout << "  --profile=<file>: Write the profile report as JSON to <file> (needs make PROFILE=1)" << std::endl;
 }
 
 // Helper function to print module information
-void printModuleInfo(const std::map<std::string, std::shared_ptr<Module>>& modules) {
+void printModuleInfo(const std::map<ModuleId, std::shared_ptr<Module>>& modules) {
     std::cout << "Module Information:" << std::endl;
     std::cout << std::left << std::setw(10) << "Name" 
               << std::setw(8) << "Width" 
@@ -52,30 +63,87 @@ void printSymmetryInfo(const std::vector<std::shared_ptr<SymmetryGroup>>& symmet
         std::cout << "  Type: " << (group->getType() == SymmetryType::VERTICAL ? "Vertical" : "Horizontal") << std::endl;
         std::cout << "  Symmetry Pairs: " << group->getNumPairs() << std::endl;
         for (const auto& pair : group->getSymmetryPairs()) {
-            std::cout << "    (" << pair.first << ", " << pair.second << ")" << std::endl;
+            std::cout << "    (" << moduleName(pair.first) << ", " << moduleName(pair.second) << ")" << std::endl;
         }
         std::cout << "  Self-Symmetric Modules: " << group->getNumSelfSymmetric() << std::endl;
-        for (const auto& name : group->getSelfSymmetric()) {
-            std::cout << "    " << name << std::endl;
+        for (ModuleId id : group->getSelfSymmetric()) {
+            std::cout << "    " << moduleName(id) << std::endl;
         }
     }
 }
 
 int main(int argc, char* argv[]) {
+    // Profile report at exit (a no-op unless built with PROFILE=1)
+    std::atexit(Profiler::report);
+    
+    // Split command line arguments into positional arguments and --options
+    std::vector<std::string> positional;
+    std::string islandLibraryPath;
+    PlacementEngine engine = PlacementEngine::SLICING;
+    int outlineWidth = 0;
+    int outlineHeight = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            positional.push_back(arg);
+        } else if (arg.rfind("--island-library=", 0) == 0) {
+            islandLibraryPath = arg.substr(std::string("--island-library=").size());
+        } else if (arg == "--engine=slicing") {
+            engine = PlacementEngine::SLICING;
+        } else if (arg == "--engine=seqpair") {
+            engine = PlacementEngine::SEQUENCE_PAIR;
+        } else if (arg == "--engine=bstar") {
+            engine = PlacementEngine::BSTAR_TREE;
+        } else if (arg == "--engine=multilevel") {
+            engine = PlacementEngine::MULTILEVEL;
+        } else if (arg.rfind("--anneal-trace=", 0) == 0) {
+            std::string tracePath = arg.substr(std::string("--anneal-trace=").size());
+            if (!AnnealingTrace::open(tracePath)) {
+                std::cerr << "Error: cannot write annealing trace " << tracePath << std::endl;
+                return 1;
+            }
+            std::atexit(AnnealingTrace::close);
+        } else if (arg.rfind("--chrome-trace=", 0) == 0) {
+            ChromeTrace::setOutputPath(arg.substr(std::string("--chrome-trace=").size()));
+            std::atexit(ChromeTrace::write);
+        } else if (arg.rfind("--profile=", 0) == 0) {
+            Profiler::setReportPath(arg.substr(std::string("--profile=").size()));
+        } else if (arg.rfind("--outline=", 0) == 0) {
+            std::string dims = arg.substr(std::string("--outline=").size());
+            size_t separator = dims.find('x');
+            try {
+                if (separator == std::string::npos) throw std::invalid_argument("missing 'x'");
+                outlineWidth = std::stoi(dims.substr(0, separator));
+                outlineHeight = std::stoi(dims.substr(separator + 1));
+            } catch (const std::exception& e) {
+                std::cerr << "Error parsing outline " << dims << ": " << e.what() << std::endl;
+                return 1;
+            }
+            if (outlineWidth <= 0 || outlineHeight <= 0) {
+                std::cerr << "Error: Outline dimensions must be positive" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
     // Check command line arguments
-    if (argc < 3 || argc > 4) {
+    if (positional.size() < 2 || positional.size() > 3) {
         printUsage(argv[0]);
         return 1;
     }
 
-    std::string inputFile = argv[1];
-    std::string outputFile = argv[2];
+    std::string inputFile = positional[0];
+    std::string outputFile = positional[1];
     double areaRatio = 1.0;  // Default area weight ratio
     
     // Parse optional area ratio parameter
-    if (argc == 4) {
+    if (positional.size() == 3) {
         try {
-            areaRatio = std::stod(argv[3]);
+            areaRatio = std::stod(positional[2]);
             if (areaRatio < 0.0) {
                 std::cerr << "Error: Area ratio must be non-negative" << std::endl;
                 return 1;
@@ -90,11 +158,12 @@ int main(int argc, char* argv[]) {
     clock_t startTime = clock();
     
     // Parse input file
-    std::map<std::string, std::shared_ptr<Module>> modules;
+    std::map<ModuleId, std::shared_ptr<Module>> modules;
     std::vector<std::shared_ptr<SymmetryGroup>> symmetryGroups;
+    std::vector<Net> nets;
     
     std::cout << "Parsing input file: " << inputFile << std::endl;
-    if (!Parser::parseInputFile(inputFile, modules, symmetryGroups)) {
+    if (!Parser::parseInputFile(inputFile, modules, symmetryGroups, nets)) {
         std::cerr << "Error parsing input file" << std::endl;
         return 1;
     }
@@ -106,9 +175,17 @@ int main(int argc, char* argv[]) {
     // Configure and run placement solver
     PlacementSolver solver;
     
+    if (!islandLibraryPath.empty()) {
+        solver.setIslandLibraryPath(islandLibraryPath);
+    }
+    solver.setPlacementEngine(engine);
+    if (outlineWidth > 0) {
+        solver.setFixedOutline(outlineWidth, outlineHeight);
+    }
+    
     // Load problem data
     std::cout << "Loading problem data into solver..." << std::endl;
-    if (!solver.loadProblem(modules, symmetryGroups)) {
+    if (!solver.loadProblem(modules, symmetryGroups, nets)) {
         std::cerr << "Error loading problem data into solver" << std::endl;
         return 1;
     }
@@ -153,16 +230,19 @@ int main(int argc, char* argv[]) {
     }
     
     // Get the final solution
-    int solutionArea = solver.getSolutionArea();
+    Area solutionArea = solver.getSolutionArea();
     auto solutionModules = solver.getSolutionModules();
     
     std::cout << "Solution found with area: " << solutionArea << std::endl;
+    if (!nets.empty()) {
+        std::cout << "Half-perimeter wirelength: " << solver.getSolutionWirelength() << std::endl;
+    }
     
     // Verify solution
     bool allModulesPlaced = true;
     for (const auto& pair : modules) {
         if (solutionModules.find(pair.first) == solutionModules.end()) {
-            std::cerr << "Warning: Module " << pair.first << " is missing from solution" << std::endl;
+            std::cerr << "Warning: Module " << pair.second->getName() << " is missing from solution" << std::endl;
             allModulesPlaced = false;
         }
     }
@@ -0,0 +1,389 @@
+#include "multilevel_sa.hpp"
+#include "../Logger.hpp"
+#include "../ChromeTrace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace {
+const int NONE = BStarArrayTree::NONE;
+
+// Refinement runs start cold: an average uphill move is accepted with this probability
+const double REFINEMENT_ACCEPTANCE = 0.1;
+
+// Share of the budget spent on the coarsest level
+const double COARSEST_SHARE = 0.6;
+
+// Nets larger than this say little about which blocks belong together
+const size_t MAX_CLUSTERING_NET_DEGREE = 16;
+
+// Clusters whose blocks fill less of their bounding box than this are not
+// formed; measured against the blocks themselves, so slack cannot compound
+// over the levels
+const double MIN_PAIR_FILL = 0.8;
+
+// Similar-area candidates tried per block when pairing by size
+const int SIZE_MATCH_WINDOW = 8;
+}
+
+MultilevelAnnealer::MultilevelAnnealer(FloorplanData* data)
+    : data(data), wirelengthModel(nullptr), areaWeight(1.0), wirelengthWeight(0.0),
+      timeLimit(230.0), coarsestSize(64), bestArea(std::numeric_limits<Area>::max()) {
+}
+
+void MultilevelAnnealer::setTimeLimit(double seconds) {
+    timeLimit = seconds;
+}
+
+void MultilevelAnnealer::setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight) {
+    // Without nets or weight the cost stays the plain area
+    if (model && model->empty()) model = nullptr;
+    if (wirelengthWeight <= 0.0) model = nullptr;
+
+    wirelengthModel = model;
+    this->areaWeight = areaWeight;
+    this->wirelengthWeight = wirelengthWeight;
+}
+
+void MultilevelAnnealer::setCoarsestSize(int size) {
+    coarsestSize = std::max(2, size);
+}
+
+bool MultilevelAnnealer::coarsen() {
+    const Level& fine = levels.back();
+    int n = fine.size();
+
+    Area totalArea = 0;
+    for (int e = 0; e < n; e++) {
+        totalArea += fine.blockArea[e];
+    }
+    // Keep clusters small enough that the coarsest level still has about
+    // coarsestSize of them
+    const Area maxClusterArea = std::max<Area>(1, totalArea / coarsestSize);
+
+    // Best layout of a pair: side by side or stacked, second rotated or not
+    struct PairShape {
+        int width, height;
+        bool vertical, secondRotated;
+        Area area;
+    };
+    auto pairShape = [&](int a, int b) {
+        PairShape best = {0, 0, false, false, std::numeric_limits<Area>::max()};
+        for (int rot = 0; rot < 2; rot++) {
+            int wb = rot ? fine.heights[b] : fine.widths[b];
+            int hb = rot ? fine.widths[b] : fine.heights[b];
+            for (int vert = 0; vert < 2; vert++) {
+                int w = vert ? std::max(fine.widths[a], wb) : fine.widths[a] + wb;
+                int h = vert ? fine.heights[a] + hb : std::max(fine.heights[a], hb);
+                Area area = areaOf(w, h);
+                if (area < best.area) best = {w, h, vert != 0, rot != 0, area};
+            }
+        }
+        return best;
+    };
+    auto fill = [&](int a, int b, const PairShape& shape) {
+        return static_cast<double>(fine.blockArea[a] + fine.blockArea[b]) / shape.area;
+    };
+    // A cluster that fits the outline in neither orientation could never be
+    // placed inside it
+    const Outline outline = data->getOutline();
+    auto acceptable = [&](int a, int b, const PairShape& shape) {
+        return shape.area <= maxClusterArea && fill(a, b, shape) >= MIN_PAIR_FILL &&
+               (outline.fits(shape.width, shape.height) || outline.fits(shape.height, shape.width));
+    };
+
+    std::vector<int> match(n, NONE);
+
+    // Heavy-edge matching: pair each block with its most connected free
+    // neighbour, weighting a net of degree d by 1 / (d - 1)
+    if (!fine.nets.empty()) {
+        std::vector<std::vector<int>> entityNets(n);
+        for (size_t net = 0; net < fine.nets.size(); net++) {
+            if (fine.nets[net].size() > MAX_CLUSTERING_NET_DEGREE) continue;
+            for (int e : fine.nets[net]) entityNets[e].push_back(static_cast<int>(net));
+        }
+
+        std::vector<int> visitOrder(n);
+        for (int e = 0; e < n; e++) visitOrder[e] = e;
+        for (int i = n - 1; i > 0; i--) std::swap(visitOrder[i], visitOrder[std::rand() % (i + 1)]);
+
+        std::vector<double> score(n, 0.0);
+        std::vector<int> touched;
+        for (int u : visitOrder) {
+            if (match[u] != NONE) continue;
+
+            touched.clear();
+            for (int net : entityNets[u]) {
+                double weight = 1.0 / (fine.nets[net].size() - 1);
+                for (int v : fine.nets[net]) {
+                    if (v == u || match[v] != NONE) continue;
+                    if (score[v] == 0.0) touched.push_back(v);
+                    score[v] += weight;
+                }
+            }
+
+            int bestPartner = NONE;
+            double bestScore = 0.0;
+            for (int v : touched) {
+                PairShape shape = pairShape(u, v);
+                if (acceptable(u, v, shape) && score[v] * fill(u, v, shape) > bestScore) {
+                    bestScore = score[v] * fill(u, v, shape);
+                    bestPartner = v;
+                }
+                score[v] = 0.0;
+            }
+            if (bestPartner != NONE) {
+                match[u] = bestPartner;
+                match[bestPartner] = u;
+            }
+        }
+    }
+
+    // Pair the remaining blocks with the best-fitting of the next few
+    // blocks in area order
+    std::vector<int> bySize;
+    for (int e = 0; e < n; e++) {
+        if (match[e] == NONE) bySize.push_back(e);
+    }
+    std::sort(bySize.begin(), bySize.end(), [&](int a, int b) {
+        return fine.blockArea[a] < fine.blockArea[b];
+    });
+    for (size_t i = 0; i < bySize.size(); i++) {
+        int a = bySize[i];
+        if (match[a] != NONE) continue;
+
+        int bestPartner = NONE;
+        double bestFill = 0.0;
+        for (size_t j = i + 1; j < bySize.size() && j <= i + SIZE_MATCH_WINDOW; j++) {
+            int b = bySize[j];
+            if (match[b] != NONE) continue;
+            PairShape shape = pairShape(a, b);
+            if (acceptable(a, b, shape) && fill(a, b, shape) > bestFill) {
+                bestFill = fill(a, b, shape);
+                bestPartner = b;
+            }
+        }
+        if (bestPartner != NONE) {
+            match[a] = bestPartner;
+            match[bestPartner] = a;
+        }
+    }
+
+    // Build the coarse level
+    Level coarse;
+    std::vector<int> clusterOf(n, NONE);
+    for (int u = 0; u < n; u++) {
+        if (clusterOf[u] != NONE) continue;
+        int cluster = coarse.size();
+        int v = match[u];
+
+        clusterOf[u] = cluster;
+        coarse.first.push_back(u);
+        if (v == NONE) {
+            coarse.second.push_back(NONE);
+            coarse.widths.push_back(fine.widths[u]);
+            coarse.heights.push_back(fine.heights[u]);
+            coarse.blockArea.push_back(fine.blockArea[u]);
+            coarse.vertical.push_back(0);
+            coarse.secondRotated.push_back(0);
+        } else {
+            PairShape shape = pairShape(u, v);
+            clusterOf[v] = cluster;
+            coarse.second.push_back(v);
+            coarse.widths.push_back(shape.width);
+            coarse.heights.push_back(shape.height);
+            coarse.blockArea.push_back(fine.blockArea[u] + fine.blockArea[v]);
+            coarse.vertical.push_back(shape.vertical);
+            coarse.secondRotated.push_back(shape.secondRotated);
+        }
+    }
+
+    // Stop once matching no longer shrinks the problem noticeably
+    if (coarse.size() > n * 9 / 10) {
+        return false;
+    }
+
+    for (const auto& net : fine.nets) {
+        std::vector<int> clusters;
+        for (int e : net) clusters.push_back(clusterOf[e]);
+        std::sort(clusters.begin(), clusters.end());
+        clusters.erase(std::unique(clusters.begin(), clusters.end()), clusters.end());
+        if (clusters.size() >= 2) coarse.nets.push_back(std::move(clusters));
+    }
+
+    levels.push_back(std::move(coarse));
+    return true;
+}
+
+BStarArrayTree MultilevelAnnealer::uncoarsen(int level, const BStarArrayTree& tree) const {
+    const Level& coarse = levels[level];
+    const Level& fine = levels[level - 1];
+    int n = fine.size();
+
+    // Node i of the finer tree holds entity i
+    std::vector<int> left(n, NONE), right(n, NONE), blockAt(n), rotated(n, 0);
+    for (int e = 0; e < n; e++) blockAt[e] = e;
+
+    // Each coarse node becomes head (bottom or left entity) and tail
+    std::vector<int> head(coarse.size()), tail(coarse.size());
+    std::vector<char> stacked(coarse.size(), 0);
+    for (int node = 0; node < tree.size(); node++) {
+        int cluster = tree.getBlockAt(node);
+        bool clusterRotated = tree.isRotated(cluster);
+        int a = coarse.first[cluster];
+        int b = coarse.second[cluster];
+
+        rotated[a] = clusterRotated;
+        if (b == NONE) {
+            head[node] = tail[node] = a;
+            continue;
+        }
+        rotated[b] = clusterRotated != (coarse.secondRotated[cluster] != 0);
+
+        // Rotating a cluster turns side-by-side into stacked and back
+        bool vertical = (coarse.vertical[cluster] != 0) != clusterRotated;
+        if (vertical) {
+            // The wider entity goes at the bottom so the head's left subtree
+            // starts right of both, as it did next to the cluster
+            int widthA = rotated[a] ? fine.heights[a] : fine.widths[a];
+            int widthB = rotated[b] ? fine.heights[b] : fine.widths[b];
+            if (widthB > widthA) std::swap(a, b);
+            right[a] = b;
+        } else {
+            left[a] = b;
+        }
+        head[node] = a;
+        tail[node] = b;
+        stacked[node] = vertical;
+    }
+
+    // The coarse node's left subtree continues right of the pair, its right
+    // subtree on top of it
+    for (int node = 0; node < tree.size(); node++) {
+        int leftChild = tree.getLeft(node) != NONE ? head[tree.getLeft(node)] : NONE;
+        int rightChild = tree.getRight(node) != NONE ? head[tree.getRight(node)] : NONE;
+        if (head[node] == tail[node]) {
+            left[head[node]] = leftChild;
+            right[head[node]] = rightChild;
+        } else if (stacked[node]) {
+            left[head[node]] = leftChild;
+            right[tail[node]] = rightChild;
+        } else {
+            left[tail[node]] = leftChild;
+            right[head[node]] = rightChild;
+        }
+    }
+
+    BStarArrayTree result;
+    result.build(head[tree.getRoot()], left, right, blockAt, rotated);
+    return result;
+}
+
+BStarArrayTree MultilevelAnnealer::anneal(int level, const BStarArrayTree* start, double seconds) {
+    const Level& current = levels[level];
+    BStarTreeAnnealer annealer(current.widths, current.heights);
+    annealer.setTimeLimit(std::max(0.05, seconds));
+    annealer.setOutline(data->getOutline());
+
+    // Coarse levels put every pin at its cluster's center
+    HPWLEvaluator clusterWirelength;
+    if (wirelengthModel) {
+        if (level == 0) {
+            annealer.setWirelengthModel(wirelengthModel, areaWeight, wirelengthWeight);
+        } else {
+            clusterWirelength.reset(current.size());
+            for (const auto& net : current.nets) {
+                int id = clusterWirelength.addNet();
+                for (int e : net) {
+                    clusterWirelength.addPin(id, e, current.widths[e], current.heights[e]);
+                }
+            }
+            clusterWirelength.finalize();
+            annealer.setWirelengthModel(&clusterWirelength, areaWeight, wirelengthWeight);
+        }
+    }
+
+    if (start) {
+        annealer.setInitialTree(*start);
+        annealer.setInitialAcceptance(REFINEMENT_ACCEPTANCE);
+    }
+    annealer.setTraceRun("multilevel", level);
+    annealer.run();
+    return annealer.getBestTree();
+}
+
+void MultilevelAnnealer::run() {
+    auto startTime = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    // Level 0: the blocks and the nets between them
+    levels.clear();
+    levels.emplace_back();
+    Level& blocks = levels.back();
+    int n = data->getNumBlocks();
+    for (int i = 0; i < n; i++) {
+        blocks.widths.push_back(data->getBlock(i)->getWidth());
+        blocks.heights.push_back(data->getBlock(i)->getHeight());
+        blocks.blockArea.push_back(areaOf(blocks.widths.back(), blocks.heights.back()));
+        blocks.first.push_back(i);
+        blocks.second.push_back(NONE);
+        blocks.vertical.push_back(0);
+        blocks.secondRotated.push_back(0);
+    }
+    if (wirelengthModel) {
+        std::vector<int> objects;
+        for (size_t net = 0; net < wirelengthModel->getNumNets(); net++) {
+            wirelengthModel->getNetObjects(static_cast<int>(net), objects);
+            std::sort(objects.begin(), objects.end());
+            objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+            if (objects.size() >= 2) blocks.nets.push_back(objects);
+        }
+    }
+
+    {
+        ChromeTrace::Scope trace("coarsen", "multilevel");
+        while (levels.back().size() > coarsestSize && coarsen()) {
+        }
+    }
+
+    int top = static_cast<int>(levels.size()) - 1;
+    std::string sizes;
+    for (const auto& level : levels) {
+        sizes += (sizes.empty() ? "" : " -> ") + std::to_string(level.size());
+    }
+    Logger::log("Multilevel placement over " + std::to_string(levels.size()) + " levels: " + sizes);
+
+    if (n == 0) {
+        bestArea = 0;
+        return;
+    }
+
+    BStarArrayTree tree = anneal(top, nullptr, timeLimit * (top == 0 ? 1.0 : COARSEST_SHARE));
+
+    // Refine level by level; each level gets a share of what is left in
+    // proportion to its size
+    long long remainingSize = 0;
+    for (int level = 0; level < top; level++) remainingSize += levels[level].size();
+    for (int level = top - 1; level >= 0; level--) {
+        tree = uncoarsen(level + 1, tree);
+        double seconds = (timeLimit - elapsed()) * levels[level].size() / remainingSize;
+        remainingSize -= levels[level].size();
+        tree = anneal(level, &tree, seconds);
+    }
+
+    tree.pack(levels[0].widths, levels[0].heights);
+    for (int i = 0; i < n; i++) {
+        Block* block = data->getBlock(i);
+        block->setX(tree.getX(i));
+        block->setY(tree.getY(i));
+        block->setRotated(tree.isRotated(i));
+    }
+    bestArea = areaOf(tree.getPackedWidth(), tree.getPackedHeight());
+
+    Logger::log("Multilevel placement finished: area " + std::to_string(bestArea) +
+        " in " + std::to_string(elapsed()) + " s");
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../bstar/bstar_sa.hpp"
+#include "../slicing/slicing_struct.hpp"
+#include "../data_struct/HPWLEvaluator.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Multilevel B*-tree placement for large block counts
+ *
+ * Coarsening pairs blocks into rigid two-block clusters, level by level,
+ * until few enough remain: connected blocks first (heavy-edge matching over
+ * the nets), then blocks of similar area. Each pair is laid out side by
+ * side or stacked, whichever wastes the least area.
+ *
+ * The coarsest level is annealed with the B*-tree engine. Uncoarsening
+ * splits every cluster node into a two-node subtree that packs like the
+ * cluster did, then refines the finer tree with a short low-temperature
+ * B*-tree run. One flat anneal over n blocks thus becomes a series of runs
+ * whose early levels are small and cheap.
+ */
+class MultilevelAnnealer {
+public:
+    MultilevelAnnealer(FloorplanData* data);
+
+    // Wall-clock budget of run() in seconds, over all levels
+    void setTimeLimit(double seconds);
+
+    // Add weighted wirelength to the cost; model objects are block indices
+    void setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight);
+
+    // Stop coarsening at this many clusters (default 64)
+    void setCoarsestSize(int size);
+
+    // Anneal and write the best packing to the blocks
+    void run();
+
+    Area getBestArea() const { return bestArea; }
+
+private:
+    /**
+     * One level of the hierarchy; level 0 holds the blocks themselves
+     *
+     * Cluster c of level l + 1 consists of entities first[c] and second[c]
+     * (NONE for a singleton) of level l.
+     */
+    struct Level {
+        std::vector<int> widths;
+        std::vector<int> heights;
+        std::vector<Area> blockArea;   // Area of the blocks inside, without slack
+        std::vector<int> first;
+        std::vector<int> second;
+        std::vector<char> vertical;         // second stacked on first (else right of it)
+        std::vector<char> secondRotated;    // second rotated inside the cluster
+        std::vector<std::vector<int>> nets; // Distinct entities per net
+
+        int size() const { return static_cast<int>(widths.size()); }
+    };
+
+    FloorplanData* data;
+    HPWLEvaluator* wirelengthModel;
+    double areaWeight;
+    double wirelengthWeight;
+    double timeLimit;
+    int coarsestSize;
+    Area bestArea;
+
+    std::vector<Level> levels;
+
+    /**
+     * Builds the next coarser level from the last one
+     *
+     * @return False if the level would barely shrink
+     */
+    bool coarsen();
+
+    /**
+     * Splits the clusters of a level's tree into a tree over the level below
+     *
+     * @param level Level the tree is over (>= 1)
+     */
+    BStarArrayTree uncoarsen(int level, const BStarArrayTree& tree) const;
+
+    /**
+     * Anneals a level, starting from the given tree if any
+     */
+    BStarArrayTree anneal(int level, const BStarArrayTree* start, double seconds);
+};
@@ -1,4 +1,6 @@
 #include "../parser/Parser.hpp"
+#include "../Profiler.hpp"
+#include "../ChromeTrace.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -10,11 +12,18 @@
  * Parses the input file and creates Module and SymmetryGroup objects
  */
 bool Parser::parseInputFile(const std::string& filename, 
-                           std::map<std::string, std::shared_ptr<Module>>& modules,
-                           std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups) {
+                           std::map<ModuleId, std::shared_ptr<Module>>& modules,
+                           std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups,
+                           std::vector<Net>& nets) {
+    HW4_PROFILE_SCOPE("Parser::parseInputFile");
+    ChromeTrace::Scope trace("parseInputFile", "io");
+    
     // Clear the output containers
+    SymbolTable& symbols = SymbolTable::modules();
+    auto geometry = std::make_shared<GeometryStore>();  // Shared by all modules, indexed by id
     modules.clear();
     symmetryGroups.clear();
+    nets.clear();
     
     // Open the input file
     std::ifstream inFile(filename);
@@ -28,6 +37,7 @@ bool Parser::parseInputFile(const std::string& filename,
     int numHardBlocks = 0;
     int numSymGroups = 0;
     int currentSymGroupIndex = -1;
+    int numNets = -1;  // -1: no NumNets line, nets are optional
     
     while (std::getline(inFile, line)) {
         // Skip empty lines and comments
@@ -54,8 +64,8 @@ bool Parser::parseInputFile(const std::string& filename,
             iss >> name >> width >> height;
             
             // Create a module object
-            auto module = std::make_shared<Module>(name, width, height);
-            modules[name] = module;
+            ModuleId id = symbols.intern(name);
+            modules[id] = std::make_shared<Module>(geometry, id, width, height);
             
             std::cout << "Hard block: " << name << " " << width << " " << height << std::endl;
         } 
@@ -84,7 +94,7 @@ bool Parser::parseInputFile(const std::string& filename,
             
             // Add the symmetry pair to the current symmetry group
             if (currentSymGroupIndex >= 0 && currentSymGroupIndex < static_cast<int>(symmetryGroups.size())) {
-                symmetryGroups[currentSymGroupIndex]->addSymmetryPair(name1, name2);
+                symmetryGroups[currentSymGroupIndex]->addSymmetryPair(symbols.intern(name1), symbols.intern(name2));
                 std::cout << "Symmetry pair: " << name1 << " " << name2 << std::endl;
             } else {
                 std::cerr << "Error: SymPair defined outside of a SymGroup" << std::endl;
@@ -99,7 +109,7 @@ bool Parser::parseInputFile(const std::string& filename,
             
             // Add the self-symmetric module to the current symmetry group
             if (currentSymGroupIndex >= 0 && currentSymGroupIndex < static_cast<int>(symmetryGroups.size())) {
-                symmetryGroups[currentSymGroupIndex]->addSelfSymmetric(name);
+                symmetryGroups[currentSymGroupIndex]->addSelfSymmetric(symbols.intern(name));
                 std::cout << "Self-symmetric module: " << name << std::endl;
             } else {
                 std::cerr << "Error: SymSelf defined outside of a SymGroup" << std::endl;
@@ -107,6 +117,37 @@ bool Parser::parseInputFile(const std::string& filename,
                 return false;
             }
         } 
+        else if (keyword == "NumNets") {
+            // Parse the number of nets
+            iss >> numNets;
+            std::cout << "Number of nets: " << numNets << std::endl;
+        }
+        else if (keyword == "Net") {
+            // Parse a net definition; its pins follow on Pin lines
+            std::string name;
+            int degree;
+            iss >> name >> degree;
+            
+            nets.emplace_back(name);
+            nets.back().pins.reserve(degree > 0 ? degree : 0);
+        }
+        else if (keyword == "Pin") {
+            // Parse a pin: block name and optional offset from the block center
+            std::string name;
+            int offsetX = 0, offsetY = 0;
+            iss >> name;
+            if (!(iss >> offsetX >> offsetY)) {
+                offsetX = 0;
+                offsetY = 0;
+            }
+            
+            if (nets.empty()) {
+                std::cerr << "Error: Pin defined outside of a Net" << std::endl;
+                inFile.close();
+                return false;
+            }
+            nets.back().pins.emplace_back(symbols.intern(name), offsetX, offsetY);
+        }
         else {
             // Unknown keyword
             std::cerr << "Warning: Unknown keyword " << keyword << std::endl;
@@ -132,18 +173,34 @@ bool Parser::parseInputFile(const std::string& filename,
     for (const auto& group : symmetryGroups) {
         for (const auto& pair : group->getSymmetryPairs()) {
             if (modules.find(pair.first) == modules.end()) {
-                std::cerr << "Error: Module " << pair.first << " in symmetry pair does not exist" << std::endl;
+                std::cerr << "Error: Module " << symbols.name(pair.first) << " in symmetry pair does not exist" << std::endl;
                 return false;
             }
             if (modules.find(pair.second) == modules.end()) {
-                std::cerr << "Error: Module " << pair.second << " in symmetry pair does not exist" << std::endl;
+                std::cerr << "Error: Module " << symbols.name(pair.second) << " in symmetry pair does not exist" << std::endl;
                 return false;
             }
         }
         
-        for (const auto& name : group->getSelfSymmetric()) {
-            if (modules.find(name) == modules.end()) {
-                std::cerr << "Error: Self-symmetric module " << name << " does not exist" << std::endl;
+        for (ModuleId id : group->getSelfSymmetric()) {
+            if (modules.find(id) == modules.end()) {
+                std::cerr << "Error: Self-symmetric module " << symbols.name(id) << " does not exist" << std::endl;
+                return false;
+            }
+        }
+    }
+    
+    // Check if the number of nets matches
+    if (numNets >= 0 && static_cast<int>(nets.size()) != numNets) {
+        std::cerr << "Error: Number of nets does not match" << std::endl;
+        return false;
+    }
+    
+    // Verify that all pins refer to existing modules
+    for (const auto& net : nets) {
+        for (const auto& pin : net.pins) {
+            if (modules.find(pin.module) == modules.end()) {
+                std::cerr << "Error: Module " << symbols.name(pin.module) << " on net " << net.name << " does not exist" << std::endl;
                 return false;
             }
         }
@@ -151,7 +208,11 @@ bool Parser::parseInputFile(const std::string& filename,
     
     // Print some statistics
     std::cout << "Successfully parsed " << modules.size() << " modules and " 
-              << symmetryGroups.size() << " symmetry groups" << std::endl;
+              << symmetryGroups.size() << " symmetry groups";
+    if (!nets.empty()) {
+        std::cout << " and " << nets.size() << " nets";
+    }
+    std::cout << std::endl;
     
     return true;
 }
@@ -160,8 +221,11 @@ bool Parser::parseInputFile(const std::string& filename,
  * Writes the placement result to the output file
  */
 bool Parser::writeOutputFile(const std::string& filename,
-                            const std::map<std::string, std::shared_ptr<Module>>& modules,
-                            int totalArea) {
+                            const std::map<ModuleId, std::shared_ptr<Module>>& modules,
+                            Area totalArea) {
+    HW4_PROFILE_SCOPE("Parser::writeOutputFile");
+    ChromeTrace::Scope trace("writeOutputFile", "io");
+    
     // Open the output file
     std::ofstream outFile(filename);
     if (!outFile.is_open()) {
@@ -175,9 +239,18 @@ bool Parser::writeOutputFile(const std::string& filename,
     // Write the number of hard blocks
     outFile << "NumHardBlocks " << modules.size() << std::endl;
     
-    // Write the module positions and rotation status
+    // Write the module positions and rotation status, in name order like
+    // before modules were keyed by id, so outputs stay comparable
+    std::vector<const Module*> byName;
+    byName.reserve(modules.size());
     for (const auto& pair : modules) {
-        const auto& module = pair.second;
+        byName.push_back(pair.second.get());
+    }
+    std::sort(byName.begin(), byName.end(), [](const Module* a, const Module* b) {
+        return a->getName() < b->getName();
+    });
+    
+    for (const Module* module : byName) {
         outFile << module->getName() << " " 
                 << module->getX() << " " 
                 << module->getY() << " " 
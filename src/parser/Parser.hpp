@@ -5,30 +5,37 @@
 #include <map>
 #include "../data_struct/Module.hpp"
 #include "../data_struct/SymmetryConstraint.hpp"
+#include "../data_struct/Net.hpp"
 
 class Parser {
 public:
     /**
      * Parses the input file and creates Module and SymmetryGroup objects
      * 
+     * Module names are interned into SymbolTable::modules() as they are
+     * read; the objects created here only refer to modules by id. All
+     * modules share one GeometryStore, indexed by module id.
+     * 
      * @param filename Path to the input file
-     * @param modules Output map of module names to Module objects
+     * @param modules Output map of module ids to Module objects
      * @param symmetryGroups Output vector of SymmetryGroup objects
+     * @param nets Output vector of nets (empty if the file has no net section)
      * @return True if parsing was successful, false otherwise
      */
     static bool parseInputFile(const std::string& filename, 
-                              std::map<std::string, std::shared_ptr<Module>>& modules,
-                              std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups);
+                              std::map<ModuleId, std::shared_ptr<Module>>& modules,
+                              std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups,
+                              std::vector<Net>& nets);
     
     /**
      * Writes the placement result to the output file
      * 
      * @param filename Path to the output file
-     * @param modules Map of module names to Module objects with their final positions
+     * @param modules Map of module ids to Module objects with their final positions
      * @param totalArea Total area of the placement
      * @return True if writing was successful, false otherwise
      */
     static bool writeOutputFile(const std::string& filename,
-                               const std::map<std::string, std::shared_ptr<Module>>& modules,
-                               int totalArea);
+                               const std::map<ModuleId, std::shared_ptr<Module>>& modules,
+                               Area totalArea);
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "seqpair_sa.hpp"
+#include "../Logger.hpp"
+#include "../ChromeTrace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+SequencePairAnnealer::SequencePairAnnealer(FloorplanData* data)
+    : data(data), outline(data->getOutline()), wirelengthModel(nullptr), areaWeight(1.0), wirelengthWeight(0.0),
+      timeLimit(230.0), moveSelector({0.3, 0.3, 0.25, 0.15}),
+      bestArea(std::numeric_limits<Area>::max()), moveCount(0) {
+
+    int n = data->getNumBlocks();
+    widths.resize(n);
+    heights.resize(n);
+    for (int i = 0; i < n; i++) {
+        widths[i] = data->getBlock(i)->getWidth();
+        heights[i] = data->getBlock(i)->getHeight();
+    }
+    current.reset(n);
+}
+
+void SequencePairAnnealer::setTimeLimit(double seconds) {
+    timeLimit = seconds;
+}
+
+void SequencePairAnnealer::setOutline(const Outline& outline) {
+    this->outline = outline;
+}
+
+void SequencePairAnnealer::setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight) {
+    // Without nets or weight the cost stays the plain area
+    if (model && model->empty()) model = nullptr;
+    if (wirelengthWeight <= 0.0) model = nullptr;
+
+    wirelengthModel = model;
+    this->areaWeight = areaWeight;
+    this->wirelengthWeight = wirelengthWeight;
+}
+
+double SequencePairAnnealer::evaluate(Area& area) {
+    current.pack(widths, heights);
+    area = areaOf(current.getPackedWidth(), current.getPackedHeight());
+
+    // Area outside a fixed outline is penalized (no-op without one)
+    Area areaCost = outline.cost(current.getPackedWidth(), current.getPackedHeight());
+    if (!wirelengthModel) {
+        return areaCost;
+    }
+
+    for (int i = 0; i < current.size(); i++) {
+        wirelengthModel->moveObject(i, current.getX(i), current.getY(i), current.isRotated(i));
+    }
+    return areaWeight * areaCost + wirelengthWeight * wirelengthModel->evaluate();
+}
+
+SequencePairAnnealer::Move SequencePairAnnealer::randomMove() const {
+    int n = current.size();
+    int first = std::rand() % n;
+    int second = std::rand() % (n - 1);
+    if (second >= first) second++;
+
+    MoveType type = static_cast<MoveType>(moveSelector.select());
+    return {type, first, type == ROTATE ? first : second};
+}
+
+void SequencePairAnnealer::applyMove(const Move& move) {
+    switch (move.type) {
+        case SWAP_POSITIVE: current.swapPositive(move.first, move.second); break;
+        case SWAP_NEGATIVE: current.swapNegative(move.first, move.second); break;
+        case SWAP_BOTH:     current.swapBoth(move.first, move.second); break;
+        case ROTATE:        current.rotate(move.first); break;
+    }
+}
+
+void SequencePairAnnealer::sampleMoves(AnnealingSchedule& schedule, double cost) {
+    int samples = std::max(50, 4 * current.size());
+
+    for (int i = 0; i < samples; i++) {
+        Move move = randomMove();
+        applyMove(move);
+        Area area;
+        schedule.sample(evaluate(area) - cost);
+        applyMove(move);
+    }
+}
+
+void SequencePairAnnealer::applyToBlocks(SequencePair& solution) {
+    solution.pack(widths, heights);
+    for (int i = 0; i < solution.size(); i++) {
+        Block* block = data->getBlock(i);
+        block->setX(solution.getX(i));
+        block->setY(solution.getY(i));
+        block->setRotated(solution.isRotated(i));
+    }
+}
+
+void SequencePairAnnealer::run() {
+    ChromeTrace::Scope timelineTrace("seqpair", "anneal");
+    AnnealingSchedule schedule(timeLimit);
+    int n = current.size();
+
+    Logger::log("Sequence-pair annealing over " + std::to_string(n) + " blocks");
+
+    if (n < 2) {
+        applyToBlocks(current);
+        bestArea = areaOf(current.getPackedWidth(), current.getPackedHeight());
+        return;
+    }
+
+    // Random initial sequences
+    for (int i = n - 1; i > 0; i--) {
+        current.swapPositive(i, std::rand() % (i + 1));
+        current.swapNegative(i, std::rand() % (i + 1));
+    }
+
+    Area area;
+    double cost = evaluate(area);
+    best = current;
+    double bestCost = cost;
+    bestArea = area;
+
+    // Accept an average uphill move with probability 0.9 at the start, and
+    // cool to the end of the budget
+    sampleMoves(schedule, cost);
+    schedule.calibrate();
+
+    AnnealingTrace trace("seqpair", 0, schedule);
+    const int checkInterval = 256;
+
+    while (true) {
+        if (moveCount % checkInterval == 0) {
+            if (!schedule.update()) break;
+            trace.update(cost, bestCost);
+        }
+        moveCount++;
+
+        Move move = randomMove();
+        auto moveStart = std::chrono::steady_clock::now();
+        applyMove(move);
+
+        Area newArea;
+        double newCost = evaluate(newArea);
+        double delta = newCost - cost;
+
+        bool accepted = schedule.accept(delta);
+        moveSelector.record(move.type, delta, accepted,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - moveStart).count(),
+            schedule.getTemperature());
+        trace.move(delta, accepted);
+
+        if (accepted) {
+            cost = newCost;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestArea = newArea;
+                best = current;
+            }
+        } else {
+            applyMove(move);
+        }
+    }
+
+    applyToBlocks(best);
+
+    Logger::log("Sequence-pair annealing finished: area " + std::to_string(bestArea) + ", " +
+        std::to_string(moveCount) + " moves in " + std::to_string(schedule.getElapsed()) + " s, " +
+        "swap+/swap-/swap both/rotate " + moveSelector.describe());
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "seqpair_struct.hpp"
+#include "../slicing/slicing_struct.hpp"
+#include "../data_struct/HPWLEvaluator.hpp"
+#include "../data_struct/MoveSelector.hpp"
+#include "../data_struct/AnnealingSchedule.hpp"
+#include "../data_struct/AnnealingTrace.hpp"
+#include <vector>
+
+/**
+ * @brief Simulated annealing over sequence pairs
+ *
+ * Drop-in alternative to the slicing SimulatedAnnealing: it works on the
+ * same FloorplanData blocks (regular modules and symmetry islands) and
+ * leaves the best packing in the blocks' positions and rotation flags.
+ *
+ * Moves are swaps in the positive sequence, the negative sequence or both,
+ * and rotations. Every move is its own inverse, so a rejected move is undone
+ * by applying it again. A MoveSelector adapts the mix of move types to what
+ * pays off during the run. The temperature starts from the average uphill cost
+ * of random moves and decays geometrically over the time budget.
+ */
+class SequencePairAnnealer {
+public:
+    SequencePairAnnealer(FloorplanData* data);
+
+    // Wall-clock budget of run() in seconds
+    void setTimeLimit(double seconds);
+
+    // Fixed outline to pack into (defaults to the FloorplanData's, if any)
+    void setOutline(const Outline& outline);
+
+    // Add weighted wirelength to the cost; model objects are block indices
+    void setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight);
+
+    // Anneal and write the best packing to the blocks
+    void run();
+
+    Area getBestArea() const { return bestArea; }
+    long long getMoveCount() const { return moveCount; }
+
+private:
+    enum MoveType {
+        SWAP_POSITIVE,
+        SWAP_NEGATIVE,
+        SWAP_BOTH,
+        ROTATE
+    };
+
+    struct Move {
+        MoveType type;
+        int first;
+        int second;
+    };
+
+    FloorplanData* data;
+    SequencePair current;
+    SequencePair best;
+    std::vector<int> widths;
+    std::vector<int> heights;
+    Outline outline;
+
+    HPWLEvaluator* wirelengthModel;
+    double areaWeight;
+    double wirelengthWeight;
+    double timeLimit;
+
+    MoveSelector moveSelector;
+    Area bestArea;
+    long long moveCount;
+
+    // Packs the current sequence pair and returns its cost
+    double evaluate(Area& area);
+
+    // Draws a move, its type from the move selector
+    Move randomMove() const;
+    void applyMove(const Move& move);
+
+    // Feeds the cost deltas of random moves to the schedule's calibration
+    void sampleMoves(AnnealingSchedule& schedule, double cost);
+
+    void applyToBlocks(SequencePair& solution);
+};
@@ -0,0 +1,84 @@
+#include "seqpair_struct.hpp"
+
+#include <algorithm>
+#include <utility>
+
+void SequencePair::reset(int n) {
+    positive.resize(n);
+    negative.resize(n);
+    positivePos.resize(n);
+    negativePos.resize(n);
+    for (int i = 0; i < n; i++) {
+        positive[i] = negative[i] = i;
+        positivePos[i] = negativePos[i] = i;
+    }
+    rotated.assign(n, 0);
+    x.assign(n, 0);
+    y.assign(n, 0);
+    fenwick.assign(n + 1, 0);
+    packedWidth = packedHeight = 0;
+}
+
+void SequencePair::swapPositive(int i, int j) {
+    std::swap(positive[i], positive[j]);
+    positivePos[positive[i]] = i;
+    positivePos[positive[j]] = j;
+}
+
+void SequencePair::swapNegative(int i, int j) {
+    std::swap(negative[i], negative[j]);
+    negativePos[negative[i]] = i;
+    negativePos[negative[j]] = j;
+}
+
+void SequencePair::swapBoth(int blockA, int blockB) {
+    swapPositive(positivePos[blockA], positivePos[blockB]);
+    swapNegative(negativePos[blockA], negativePos[blockB]);
+}
+
+int SequencePair::longestPath(const std::vector<int>& order, bool reverse,
+                              const std::vector<int>& lengths, std::vector<int>& coords) {
+    int n = size();
+    std::fill(fenwick.begin(), fenwick.end(), 0);
+
+    int extent = 0;
+    for (int k = 0; k < n; k++) {
+        int block = order[reverse ? n - 1 - k : k];
+        int pos = negativePos[block];
+
+        // Max end coordinate over visited blocks at negative index < pos
+        int start = 0;
+        for (int i = pos; i > 0; i -= i & -i) {
+            start = std::max(start, fenwick[i]);
+        }
+        coords[block] = start;
+
+        int end = start + lengths[block];
+        for (int i = pos + 1; i <= n; i += i & -i) {
+            fenwick[i] = std::max(fenwick[i], end);
+        }
+        extent = std::max(extent, end);
+    }
+    return extent;
+}
+
+void SequencePair::pack(const std::vector<int>& widths, const std::vector<int>& heights) {
+    int n = size();
+    if (n == 0) {
+        packedWidth = packedHeight = 0;
+        return;
+    }
+
+    // Effective dimensions after rotation
+    effWidth.resize(n);
+    effHeight.resize(n);
+    for (int b = 0; b < n; b++) {
+        effWidth[b] = rotated[b] ? heights[b] : widths[b];
+        effHeight[b] = rotated[b] ? widths[b] : heights[b];
+    }
+
+    // Left-of: earlier in both sequences
+    packedWidth = longestPath(positive, false, effWidth, x);
+    // Below: later in positive, earlier in negative
+    packedHeight = longestPath(positive, true, effHeight, y);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief Sequence-pair representation of a (possibly non-slicing) packing
+ *
+ * Block a is left of block b if a precedes b in both sequences, and below b
+ * if a follows b in the positive sequence but precedes it in the negative
+ * one. Packing computes both longest weighted common subsequences with a
+ * prefix-max Fenwick tree (Tang and Wong's LCS formulation), so one
+ * evaluation costs O(n log n) and allocates nothing after the first call.
+ */
+class SequencePair {
+public:
+    SequencePair() : packedWidth(0), packedHeight(0) {}
+
+    /**
+     * Resets to the identity sequences with n unrotated blocks
+     */
+    void reset(int n);
+
+    int size() const { return static_cast<int>(positive.size()); }
+
+    /**
+     * Packs the blocks to the lower-left
+     *
+     * @param widths Unrotated block widths
+     * @param heights Unrotated block heights
+     */
+    void pack(const std::vector<int>& widths, const std::vector<int>& heights);
+
+    // Moves; each is its own inverse, so undo is the same call again
+    void swapPositive(int i, int j);
+    void swapNegative(int i, int j);
+    void swapBoth(int blockA, int blockB);
+    void rotate(int block) { rotated[block] = !rotated[block]; }
+
+    const std::vector<int>& getPositive() const { return positive; }
+    const std::vector<int>& getNegative() const { return negative; }
+    bool isRotated(int block) const { return rotated[block] != 0; }
+
+    // Results of the last pack()
+    int getX(int block) const { return x[block]; }
+    int getY(int block) const { return y[block]; }
+    int getPackedWidth() const { return packedWidth; }
+    int getPackedHeight() const { return packedHeight; }
+
+private:
+    std::vector<int> positive;      // Block ids in positive-sequence order
+    std::vector<int> negative;      // Block ids in negative-sequence order
+    std::vector<int> positivePos;   // Block id -> index in positive
+    std::vector<int> negativePos;   // Block id -> index in negative
+    std::vector<char> rotated;
+
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<int> effWidth;
+    std::vector<int> effHeight;
+    std::vector<int> fenwick;
+    int packedWidth;
+    int packedHeight;
+
+    /**
+     * Longest weighted common subsequence pass
+     *
+     * Visits blocks in the given order; each block's coordinate is the max
+     * end coordinate of already visited blocks earlier in the negative
+     * sequence.
+     */
+    int longestPath(const std::vector<int>& order, bool reverse,
+                    const std::vector<int>& lengths, std::vector<int>& coords);
+};
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "slicing_struct.hpp"
+#include "../data_struct/HPWLEvaluator.hpp"
+#include "../data_struct/MoveSelector.hpp"
+#include "../data_struct/AnnealingSchedule.hpp"
+#include "../data_struct/AnnealingTrace.hpp"
+#include <functional>
 #include <vector>
 #include <utility>
 #include <unordered_map>
@@ -14,19 +19,48 @@ public:
     
     // Run the simulated annealing algorithm
     void run();
+    
+    // Wall-clock budget of run() in seconds (default 230)
+    void setTimeLimit(double seconds);
+    
+    // Debug log each annealer writes (default slicingPlacement_debug.log); empty disables it
+    static void setDebugLogPath(const std::string& path);
 
-    int calculateArea(const std::vector<int> &expression);
+    Area calculateArea(const std::vector<int> &expression);
 
     // Get the best solution found
     FloorplanSolution* getBestSolution() const;
     
+    // Add weighted wirelength to the cost; model objects are block indices
+    void setWirelengthModel(HPWLEvaluator* model, double areaWeight, double wirelengthWeight);
+    
 private:
+    // The microbenchmarks (bench/microbench.cpp) start from the private initial expressions
+    friend class MicroBench;
+    
     FloorplanData* data;
     FloorplanSolution* bestSolution;
     std::vector<std::shared_ptr<SlicingTreeNode>> blockNodes;
     std::vector<std::shared_ptr<SlicingTreeNode>> cutNodes;
+    
+    // Sweep-line overlap detection over the blocks
+    mutable OverlapDetector overlapDetector;
+    
+    // Optional wirelength term of the cost (nullptr: area only)
+    HPWLEvaluator* wirelengthModel;
+    double areaWeight;
+    double wirelengthWeight;
+    
+    double timeLimit;
+    
+    // Start index tagging the trace records of the next anneal()
+    int traceStart;
+    
+    // Shape records at the root of the last tree costed
+    size_t rootShapeRecords;
 
     // Logger members
+    static std::string debugLogPath;
     mutable std::ofstream slicingLogFile;
     mutable bool slicingDebugEnabled;
     void initSlicingDebugger();
@@ -43,21 +77,19 @@ private:
     
     // Helper functions
     bool isCut(int id) const;
-    bool isSkewed(const std::vector<int>& expression, size_t index) const;
-    bool satisfiesBallotProperty(const std::vector<int>& expression, size_t index) const;
     
     // Validate a Polish expression
     bool validatePolishExpression(const std::vector<int>& expression) const;
     
-    // Generate a neighboring solution
-    std::vector<int> perturbExpression(const std::vector<int>& expression, int moveType) const;
-    
     // Slicing tree construction and evaluation
     std::shared_ptr<SlicingTreeNode> buildSlicingTree(const std::vector<int>& expression);
     void setBlockPositions(SlicingTreeNode* node, int x, int y, int recordIndex);
     
     // Calculate the cost of a solution
-    int calculateCost(const std::vector<int>& expression, bool includeArea);
+    Area calculateCost(const std::vector<int>& expression, bool includeArea);
+    
+    // HPWL of the current block positions (only nets on moved blocks are updated)
+    double calculateWirelength();
     
     // Direct repair of invalid floorplans
     bool repairFloorplan();
@@ -65,23 +97,35 @@ private:
     bool hasOverlaps(const FloorplanSolution *solution) const;
 
     // The simulated annealing algorithm for both area and wirelength optimization
-    std::pair<std::vector<int>, int> runSimulatedAnnealing(
+    std::pair<std::vector<int>, Area> runSimulatedAnnealing(
         std::vector<int> expression, 
         bool includeArea,
-        double initialTemperature,
-        double minTemperature,
-        double coolingRate,
-        int movesPerTemperature,
-        double maxRejectRatio,
-        double maxRuntime = 180.0
+        double maxRuntime
     );
     
-    // Method for wirelength optimization
+    // Area-only refinement of a placement found by runSimulatedAnnealing
     std::vector<int> runAreaOptimization(
         const std::vector<int>& initialExpression,
-        double initialTemperature,
-        double coolingRate,
         double maxRuntime
     );
     
+    /**
+     * Anneals from the given expression until the schedule's budget is spent
+     * 
+     * The schedule is calibrated on random moves first, so the temperature
+     * matches the scale of costOf on this design. Moves edit one
+     * PolishExpression in place and rejected moves are undone, so only a new
+     * best expression is copied. Steps are traced under traceEngine and the
+     * current traceStart.
+     * 
+     * @return Best expression found and its cost
+     */
+    std::pair<std::vector<int>, Area> anneal(
+        std::vector<int> expression,
+        const std::function<Area(const std::vector<int>&)>& costOf,
+        MoveSelector& moveSelector,
+        AnnealingSchedule& schedule,
+        const char* traceEngine
+    );
+    
 };
@@ -1,15 +1,15 @@
 #include "slicing_struct.hpp"
+#include "../Profiler.hpp"
 #include <algorithm>
+#include <cassert>
+#include <cstdlib>
 #include <limits>
 #include <iostream>
 #include <stack>
 
 // Block implementation
-Block::Block(const std::string& name, int width, int height)
-    : name(name), width(width), height(height), x(0), y(0), rotated(false) {
-}
-
-Block::~Block() {
+Block::Block(const std::string& name, GeometryStore* geometry, int index)
+    : name(name), geometry(geometry), index(index) {
 }
 
 const std::string& Block::getName() const {
@@ -17,49 +17,48 @@ const std::string& Block::getName() const {
 }
 
 int Block::getWidth() const {
-    return width;
+    return geometry->getWidth(index);
 }
 
 int Block::getHeight() const {
-    return height;
+    return geometry->getHeight(index);
 }
 
 int Block::getX() const {
-    return x;
+    return geometry->getX(index);
 }
 
 int Block::getY() const {
-    return y;
+    return geometry->getY(index);
 }
 
 bool Block::isRotated() const {
-    return rotated;
+    return geometry->isRotated(index);
 }
 
 void Block::setX(int x) {
-    this->x = x;
+    geometry->setPosition(index, x, getY());
 }
 
 void Block::setY(int y) {
-    this->y = y;
+    geometry->setPosition(index, getX(), y);
 }
 
 void Block::setRotated(bool rotated) {
-    this->rotated = rotated;
+    geometry->setRotated(index, rotated);
 }
 
 void Block::updatePosition(int x, int y, int width, int height) {
-    this->x = x;
-    this->y = y;
-    this->rotated = !(this->width == width && this->height == height);
+    geometry->setPosition(index, x, y);
+    geometry->setRotated(index, !(getWidth() == width && getHeight() == height));
 }
 
 int Block::getCenterX() const {
-    return x + (rotated ? height : width) / 2;
+    return getX() + geometry->getEffectiveWidth(index) / 2;
 }
 
 int Block::getCenterY() const {
-    return y + (rotated ? width : height) / 2;
+    return getY() + geometry->getEffectiveHeight(index) / 2;
 }
 
 // FloorplanData implementation
@@ -67,14 +66,13 @@ FloorplanData::FloorplanData()
     : floorplanWidth(0), floorplanHeight(0) {
 }
 
-FloorplanData::~FloorplanData() {
-    for (Block* block : blocks) {
-        delete block;
-    }
+int FloorplanData::addBlock(const std::string& name, int width, int height) {
+    return addBlock(name, &geometry, geometry.add(width, height));
 }
 
-void FloorplanData::addBlock(Block* block) {
-    blocks.push_back(block);
+int FloorplanData::addBlock(const std::string& name, GeometryStore* store, int entry) {
+    blocks.emplace_back(name, store, entry);
+    return static_cast<int>(blocks.size()) - 1;
 }
 
 void FloorplanData::setFloorplanDimensions(int width, int height) {
@@ -86,14 +84,18 @@ int FloorplanData::getNumBlocks() const {
     return blocks.size();
 }
 
-Block* FloorplanData::getBlock(int index) const {
-    return blocks[index];
+Block* FloorplanData::getBlock(int index) {
+    return &blocks[index];
+}
+
+const Block* FloorplanData::getBlock(int index) const {
+    return &blocks[index];
 }
 
-Block* FloorplanData::getBlockByName(const std::string& name) const {
-    for (Block* block : blocks) {
-        if (block->getName() == name) {
-            return block;
+Block* FloorplanData::getBlockByName(const std::string& name) {
+    for (Block& block : blocks) {
+        if (block.getName() == name) {
+            return &block;
         }
     }
     return nullptr;
@@ -107,6 +109,16 @@ int FloorplanData::getFloorplanHeight() const {
     return floorplanHeight;
 }
 
+void FloorplanData::loadOverlapDetector(OverlapDetector& detector) const {
+    detector.clear();
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const Block& block = blocks[i];
+        int blockWidth = block.isRotated() ? block.getHeight() : block.getWidth();
+        int blockHeight = block.isRotated() ? block.getWidth() : block.getHeight();
+        detector.addRect(static_cast<int>(i), block.getX(), block.getY(), blockWidth, blockHeight);
+    }
+}
+
 // ShapeRecord implementation
 ShapeRecord::ShapeRecord()
     : width(0), height(0), leftChoice(0), rightChoice(0) {
@@ -136,32 +148,50 @@ SlicingTreeNode::~SlicingTreeNode() {
     rightChild.reset();
 }
 
-void SlicingTreeNode::updateShapeRecords() {
+void SlicingTreeNode::updateShapeRecords(int maxWidth, int maxHeight) {
+    // Hundreds of nanoseconds per call, so only a sample is timed
+    HW4_PROFILE_SCOPE_SAMPLED("SlicingTreeNode::updateShapeRecords", 16);
+    combineShapeRecords(maxWidth, maxHeight);
+    
+    if (shapeRecords.empty() && type != BLOCK) {
+        combineShapeRecords(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+    }
+}
+
+void SlicingTreeNode::combineShapeRecords(int maxWidth, int maxHeight) {
     shapeRecords.clear();
     
+    // Child curves are staircases: a wider record is never taller. Ties are
+    // broken so both dimensions stay monotone along the merge walk, which lets
+    // records outside the outline be skipped and the walk stop early.
     if (type == HORIZONTAL_CUT) {
         if (!leftChild || !rightChild) return;
         
-        // Sort by width (ascending order)
+        // Sort by width (ascending order), taller first on equal widths
         auto compareWidth = [](const ShapeRecord& a, const ShapeRecord& b) -> bool {
-            return a.width <= b.width;
+            return a.width < b.width || (a.width == b.width && a.height > b.height);
         };
         
-        std::sort(leftChild->shapeRecords.begin(), leftChild->shapeRecords.end(), compareWidth);
-        std::sort(rightChild->shapeRecords.begin(), rightChild->shapeRecords.end(), compareWidth);
+        std::vector<ShapeRecord>& leftRecords = leftChild->shapeRecords;
+        std::vector<ShapeRecord>& rightRecords = rightChild->shapeRecords;
+        std::sort(leftRecords.begin(), leftRecords.end(), compareWidth);
+        std::sort(rightRecords.begin(), rightRecords.end(), compareWidth);
         
-        int l = leftChild->shapeRecords.size() - 1;
-        int r = rightChild->shapeRecords.size() - 1;
+        // Start from the widest records that fit the outline
+        auto fitsWidth = [maxWidth](const ShapeRecord& record) { return record.width <= maxWidth; };
+        int l = static_cast<int>(std::partition_point(leftRecords.begin(), leftRecords.end(), fitsWidth) - leftRecords.begin()) - 1;
+        int r = static_cast<int>(std::partition_point(rightRecords.begin(), rightRecords.end(), fitsWidth) - rightRecords.begin()) - 1;
         
         while (l >= 0 && r >= 0) {
-            const ShapeRecord& leftRecord = leftChild->shapeRecords[l];
-            const ShapeRecord& rightRecord = rightChild->shapeRecords[r];
+            const ShapeRecord& leftRecord = leftRecords[l];
+            const ShapeRecord& rightRecord = rightRecords[r];
             
-            shapeRecords.emplace_back(
-                std::max(leftRecord.width, rightRecord.width),
-                leftRecord.height + rightRecord.height,
-                l, r
-            );
+            // Heights only grow from here on
+            int height = leftRecord.height + rightRecord.height;
+            if (height > maxHeight) break;
+            
+            int width = std::max(leftRecord.width, rightRecord.width);
+            shapeRecords.emplace_back(width, height, l, r);
             
             if (leftRecord.width >= rightRecord.width) {
                 --l;
@@ -173,25 +203,31 @@ void SlicingTreeNode::updateShapeRecords() {
     } else if (type == VERTICAL_CUT) {
         if (!leftChild || !rightChild) return;
         
-        // Sort by height (descending order)
+        // Sort by height (descending order), narrower first on equal heights
         auto compareHeight = [](const ShapeRecord& a, const ShapeRecord& b) -> bool {
-            return a.height >= b.height;
+            return a.height > b.height || (a.height == b.height && a.width < b.width);
         };
         
-        std::sort(leftChild->shapeRecords.begin(), leftChild->shapeRecords.end(), compareHeight);
-        std::sort(rightChild->shapeRecords.begin(), rightChild->shapeRecords.end(), compareHeight);
+        std::vector<ShapeRecord>& leftRecords = leftChild->shapeRecords;
+        std::vector<ShapeRecord>& rightRecords = rightChild->shapeRecords;
+        std::sort(leftRecords.begin(), leftRecords.end(), compareHeight);
+        std::sort(rightRecords.begin(), rightRecords.end(), compareHeight);
         
-        size_t l = 0, r = 0;
+        // Start from the tallest records that fit the outline
+        auto tooTall = [maxHeight](const ShapeRecord& record) { return record.height > maxHeight; };
+        size_t l = std::partition_point(leftRecords.begin(), leftRecords.end(), tooTall) - leftRecords.begin();
+        size_t r = std::partition_point(rightRecords.begin(), rightRecords.end(), tooTall) - rightRecords.begin();
         
-        while (l < leftChild->shapeRecords.size() && r < rightChild->shapeRecords.size()) {
-            const ShapeRecord& leftRecord = leftChild->shapeRecords[l];
-            const ShapeRecord& rightRecord = rightChild->shapeRecords[r];
+        while (l < leftRecords.size() && r < rightRecords.size()) {
+            const ShapeRecord& leftRecord = leftRecords[l];
+            const ShapeRecord& rightRecord = rightRecords[r];
+            
+            // Widths only grow from here on
+            int width = leftRecord.width + rightRecord.width;
+            if (width > maxWidth) break;
             
-            shapeRecords.emplace_back(
-                leftRecord.width + rightRecord.width,
-                std::max(leftRecord.height, rightRecord.height),
-                l, r
-            );
+            int height = std::max(leftRecord.height, rightRecord.height);
+            shapeRecords.emplace_back(width, height, l, r);
             
             if (leftRecord.height >= rightRecord.height) {
                 ++l;
@@ -203,6 +239,160 @@ void SlicingTreeNode::updateShapeRecords() {
     }
 }
 
+// PolishExpression implementation
+PolishExpression::PolishExpression(const std::vector<int>& tokens)
+    : tokens(tokens), slot(tokens.size()), operatorsThrough(tokens.size()) {
+    int operators = 0;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        std::vector<int>& positions = isOperator(tokens[i]) ? operatorPositions : operandPositions;
+        slot[i] = static_cast<int>(positions.size());
+        positions.push_back(static_cast<int>(i));
+        if (isOperator(tokens[i])) ++operators;
+        operatorsThrough[i] = operators;
+    }
+    equalOperatorPairs = countEqualPairs(0, size() - 1);
+}
+
+int PolishExpression::countEqualPairs(int begin, int end) const {
+    int pairs = 0;
+    for (int i = std::max(begin, 0); i < end && i + 1 < size(); ++i) {
+        if (isOperator(tokens[i]) && tokens[i] == tokens[i + 1]) ++pairs;
+    }
+    return pairs;
+}
+
+bool PolishExpression::checkInvariants() const {
+    int operators = 0;
+    size_t operands = 0;
+    for (int i = 0; i < size(); ++i) {
+        const std::vector<int>& positions = isOperator(tokens[i]) ? operatorPositions : operandPositions;
+        if (slot[i] < 0 || slot[i] >= static_cast<int>(positions.size()) || positions[slot[i]] != i) return false;
+        if (isOperator(tokens[i])) {
+            ++operators;
+        } else {
+            ++operands;
+        }
+        if (operatorsThrough[i] != operators || 2 * operators >= i + 1) return false;
+    }
+    return operands == operatorPositions.size() + 1 && equalOperatorPairs == countEqualPairs(0, size() - 1);
+}
+
+PolishExpression::Move PolishExpression::perturb(int moveType) {
+    HW4_PROFILE_SCOPE_SAMPLED("PolishExpression::perturb", 16);
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        Move move;
+        switch ((moveType + attempt) % 3) {
+            case 0: move = drawOperandSwap(); break;
+            case 1: move = drawChainComplement(); break;
+            default: move = drawOperandOperatorSwap(); break;
+        }
+        if (move.type != NO_MOVE) {
+            apply(move);
+            return move;
+        }
+    }
+    return {NO_MOVE, 0, 0};
+}
+
+PolishExpression::Move PolishExpression::drawOperandSwap() const {
+    int operands = static_cast<int>(operandPositions.size());
+    if (operands < 2) return {NO_MOVE, 0, 0};
+    
+    // Prefer the farthest of a few candidates, for more diverse swaps
+    int first = operandPositions[std::rand() % operands];
+    int second = -1;
+    if (operands > 5) {
+        int maxDistance = 0;
+        for (int i = 0; i < 5; i++) {
+            int candidate = operandPositions[std::rand() % operands];
+            int distance = std::abs(candidate - first);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                second = candidate;
+            }
+        }
+    }
+    while (second < 0 || second == first) {
+        second = operandPositions[std::rand() % operands];
+    }
+    return {SWAP_OPERANDS, first, second};
+}
+
+PolishExpression::Move PolishExpression::drawChainComplement() const {
+    if (operatorPositions.empty()) return {NO_MOVE, 0, 0};
+    
+    // Grow a random operator to its maximal run
+    int begin = operatorPositions[std::rand() % operatorPositions.size()];
+    int end = begin + 1;
+    while (begin > 0 && isOperator(tokens[begin - 1])) --begin;
+    while (end < size() && isOperator(tokens[end])) ++end;
+    return {COMPLEMENT_CHAIN, begin, end};
+}
+
+PolishExpression::Move PolishExpression::drawOperandOperatorSwap() const {
+    if (operatorPositions.empty()) return {NO_MOVE, 0, 0};
+    
+    // A few random operand neighbourhoods; most operands border an operator
+    for (int tries = 0; tries < 4; ++tries) {
+        int operand = operandPositions[std::rand() % operandPositions.size()];
+        int side = std::rand() % 2;
+        for (int k = 0; k < 2; ++k, side ^= 1) {
+            int i = side ? operand : operand - 1;  // Swap tokens i and i + 1
+            if (i < 0 || i + 1 >= size()) continue;
+            if (side && isOperator(tokens[i + 1])) {
+                // The operator moves left: prefix i gains it and must keep
+                // more operands than operators, and its new left neighbour
+                // must not be the same operator
+                if (2 * (operatorsThrough[i] + 1) < i + 1 && (i == 0 || tokens[i - 1] != tokens[i + 1])) {
+                    return {SWAP_OPERAND_OPERATOR, i, i + 1};
+                }
+            } else if (!side && isOperator(tokens[i])) {
+                // The operand moves left, which never breaks the balloting
+                // property; the operator's new right neighbour must differ
+                if (i + 2 >= size() || tokens[i + 2] != tokens[i]) return {SWAP_OPERAND_OPERATOR, i, i + 1};
+            }
+        }
+    }
+    return {NO_MOVE, 0, 0};
+}
+
+void PolishExpression::apply(const Move& move) {
+    switch (move.type) {
+        case SWAP_OPERANDS:
+            std::swap(tokens[move.first], tokens[move.second]);
+            break;
+        case COMPLEMENT_CHAIN:
+            for (int i = move.first; i < move.second; ++i) {
+                tokens[i] = tokens[i] == SlicingTreeNode::HORIZONTAL_CUT ? SlicingTreeNode::VERTICAL_CUT
+                                                                         : SlicingTreeNode::HORIZONTAL_CUT;
+            }
+            break;
+        case SWAP_OPERAND_OPERATOR: {
+            int i = move.first;
+            bool operatorMovesLeft = isOperator(tokens[i + 1]);
+            equalOperatorPairs -= countEqualPairs(i - 1, i + 2);
+            std::swap(tokens[i], tokens[i + 1]);
+            std::swap(slot[i], slot[i + 1]);
+            if (operatorMovesLeft) {
+                operatorPositions[slot[i]] = i;
+                operandPositions[slot[i + 1]] = i + 1;
+                ++operatorsThrough[i];
+            } else {
+                operandPositions[slot[i]] = i;
+                operatorPositions[slot[i + 1]] = i + 1;
+                --operatorsThrough[i];
+            }
+            equalOperatorPairs += countEqualPairs(i - 1, i + 2);
+            break;
+        }
+        case NO_MOVE:
+            break;
+    }
+#ifdef HW4_CHECKED
+    assert(checkInvariants());
+#endif
+}
+
 // FloorplanSolution implementation
 FloorplanSolution::FloorplanSolution(FloorplanData* data)
     : data(data), cost(0) {
@@ -219,11 +409,11 @@ const std::vector<int>& FloorplanSolution::getPolishExpression() const {
     return polishExpression;
 }
 
-int FloorplanSolution::getCost() const {
+Area FloorplanSolution::getCost() const {
     return cost;
 }
 
-void FloorplanSolution::setCost(int cost) {
+void FloorplanSolution::setCost(Area cost) {
     this->cost = cost;
 }
 
@@ -242,50 +432,28 @@ bool FloorplanSolution::isValid() const {
     }
     
     // Check for block overlaps
-    for (int i = 0; i < data->getNumBlocks(); ++i) {
-        Block* block1 = data->getBlock(i);
-        int block1Width = block1->isRotated() ? block1->getHeight() : block1->getWidth();
-        int block1Height = block1->isRotated() ? block1->getWidth() : block1->getHeight();
-        
-        for (int j = i + 1; j < data->getNumBlocks(); ++j) {
-            Block* block2 = data->getBlock(j);
-            int block2Width = block2->isRotated() ? block2->getHeight() : block2->getWidth();
-            int block2Height = block2->isRotated() ? block2->getWidth() : block2->getHeight();
-            
-            // Check for overlap
-            if (!(block1->getX() + block1Width <= block2->getX() || 
-                  block2->getX() + block2Width <= block1->getX() ||
-                  block1->getY() + block1Height <= block2->getY() ||
-                  block2->getY() + block2Height <= block1->getY())) {
-                return false;
-            }
-        }
-    }
-    
-    return true;
+    OverlapDetector detector;
+    data->loadOverlapDetector(detector);
+    return !detector.hasOverlap();
 }
 
 void FloorplanSolution::applyFloorplanToBlocks() {
     auto root = buildSlicingTree();
     
-    // Find the best shape record that fits within the floorplan boundaries
-    int floorplanWidth = data->getFloorplanWidth();
-    int floorplanHeight = data->getFloorplanHeight();
+    // Pick the smallest shape record, penalizing any area outside the outline
+    Outline outline = data->getOutline();
     
     int selectedRecord = -1;
+    Area selectedCost = std::numeric_limits<Area>::max();
     for (size_t i = 0; i < root->shapeRecords.size(); ++i) {
         const ShapeRecord& record = root->shapeRecords[i];
-        if (record.width <= floorplanWidth && record.height <= floorplanHeight) {
+        Area cost = outline.cost(record.width, record.height);
+        if (cost < selectedCost) {
+            selectedCost = cost;
             selectedRecord = i;
-            break;
         }
     }
     
-    // If no valid shape found, use the first one
-    if (selectedRecord == -1 && !root->shapeRecords.empty()) {
-        selectedRecord = 0;
-    }
-    
     // Set block positions
     if (selectedRecord != -1) {
         setBlockPositions(root.get(), 0, 0, selectedRecord);
@@ -313,7 +481,7 @@ std::shared_ptr<SlicingTreeNode> FloorplanSolution::buildSlicingTree() {
             nodeStack.pop();
             
             // Update shape records
-            node->updateShapeRecords();
+            node->updateShapeRecords(data->getFloorplanWidth(), data->getFloorplanHeight());
             
             // Push the new node
             nodeStack.push(node);
@@ -1,17 +1,28 @@
 #pragma once
 
+#include <deque>
 #include <string>
 #include <vector>
 #include <memory>
+#include <limits>
+
+#include "../data_struct/GeometryStore.hpp"
+#include "../data_struct/OverlapDetector.hpp"
+#include "../data_struct/Area.hpp"
+#include "../data_struct/Outline.hpp"
 
 // Forward declarations
 class Block;
 class SlicingTreeNode;
 
+/**
+ * @brief Slicing block, a view onto a GeometryStore entry
+ *
+ * Width and height are the original dimensions; rotation is a flag.
+ */
 class Block {
 public:
-    Block(const std::string& name, int width, int height);
-    ~Block();
+    Block(const std::string& name, GeometryStore* geometry, int index);
     
     const std::string& getName() const;
     int getWidth() const;
@@ -30,32 +41,40 @@ public:
     
 private:
     std::string name;
-    int width;
-    int height;
-    int x;
-    int y;
-    bool rotated;
+    GeometryStore* geometry;
+    int index;
 };
 
 class FloorplanData {
 public:
     FloorplanData();
-    ~FloorplanData();
+    FloorplanData(const FloorplanData&) = delete;
+    FloorplanData& operator=(const FloorplanData&) = delete;
+    
+    // Adds a block stored in this floorplan's own geometry; returns its index
+    int addBlock(const std::string& name, int width, int height);
     
-    // Add components
-    void addBlock(Block* block);
+    // Adds a block viewing an entry of another store, e.g. a module's; the
+    // engines then place that entry directly. Returns the block index.
+    int addBlock(const std::string& name, GeometryStore* store, int entry);
     
-    // Set floorplan dimensions and deadspace ratio
+    // Set floorplan dimensions (the fixed outline; INT_MAX for none)
     void setFloorplanDimensions(int width, int height);
     
     int getNumBlocks() const;
-    Block* getBlock(int index) const;
-    Block* getBlockByName(const std::string& name) const;
+    Block* getBlock(int index);
+    const Block* getBlock(int index) const;
+    Block* getBlockByName(const std::string& name);
     int getFloorplanWidth() const;
     int getFloorplanHeight() const;
+    Outline getOutline() const { return Outline(floorplanWidth, floorplanHeight); }
+    
+    // Load the current block rectangles into a detector (ids are block indices)
+    void loadOverlapDetector(OverlapDetector& detector) const;
     
 private:
-    std::vector<Block*> blocks;
+    GeometryStore geometry;   // Blocks that are not views onto another store
+    std::deque<Block> blocks; // A deque keeps Block addresses stable
     int floorplanWidth;
     int floorplanHeight;
 };
@@ -69,6 +88,8 @@ struct ShapeRecord {
     
     ShapeRecord();
     ShapeRecord(int w, int h, int lc, int rc);
+    
+    Area getArea() const { return areaOf(width, height); }
 };
 
 // Node in the slicing tree
@@ -84,8 +105,14 @@ public:
     SlicingTreeNode(int type, Block* block = nullptr);
     ~SlicingTreeNode();
     
-    // Update shape records
-    void updateShapeRecords();
+    /**
+     * Combines the children's shape records into this cut's shape curve
+     * 
+     * Records wider than maxWidth or taller than maxHeight are pruned. If none
+     * fits, the full curve is kept so infeasible trees can still be compared.
+     */
+    void updateShapeRecords(int maxWidth = std::numeric_limits<int>::max(),
+                            int maxHeight = std::numeric_limits<int>::max());
     
     // Member variables
     int type;
@@ -94,6 +121,87 @@ public:
     std::shared_ptr<SlicingTreeNode> rightChild;
     std::vector<ShapeRecord> shapeRecords;
     // void* userData;
+    
+private:
+    void combineShapeRecords(int maxWidth, int maxHeight);
+};
+
+/**
+ * @brief Polish expression of a slicing floorplan, perturbed in place
+ *
+ * Tokens are block indices (operands) and SlicingTreeNode cut types
+ * (operators). perturb() applies one of Wong and Liu's moves directly to
+ * the expression and returns it as a Move; every move is its own inverse,
+ * so a rejected move is undone by apply()ing it again.
+ *
+ * The positions of operands and operators and the operator count of every
+ * prefix are maintained alongside the tokens. Drawing and applying an
+ * operand swap or an operand/operator swap is O(1), including the balloting
+ * check of the latter; complementing a chain costs the chain's length.
+ *
+ * Moves also keep the expression normalized (no two equal operators in a
+ * row, so every slicing floorplan has one expression): an operand/operator
+ * swap is only drawn if its new operator neighbour differs, which is O(1),
+ * and complementing a whole chain keeps it alternating. An expression that
+ * starts out skewed never gets more equal pairs.
+ */
+class PolishExpression {
+public:
+    enum MoveType {
+        NO_MOVE,
+        SWAP_OPERANDS,          // M1: swap two operands
+        COMPLEMENT_CHAIN,       // M2: complement a maximal run of operators
+        SWAP_OPERAND_OPERATOR   // M3: swap an adjacent operand and operator
+    };
+
+    struct Move {
+        MoveType type;
+        int first;   // M1: both positions; M2: the run [first, second); M3: first and first + 1
+        int second;
+    };
+
+    PolishExpression() = default;
+
+    // The tokens must form a valid Polish expression
+    explicit PolishExpression(const std::vector<int>& tokens);
+
+    const std::vector<int>& getTokens() const { return tokens; }
+    int size() const { return static_cast<int>(tokens.size()); }
+
+    static bool isOperator(int token) { return token < 0; }
+
+    // True if no two equal operators are adjacent
+    bool isNormalized() const { return equalOperatorPairs == 0; }
+
+    /**
+     * Draws a random move and applies it
+     *
+     * @param moveType 0, 1 or 2 for M1, M2 or M3; if no move of that type
+     *        applies, the other types are tried in turn
+     * @return The applied move, of type NO_MOVE if none applies
+     */
+    Move perturb(int moveType);
+
+    // Applies a move; applying the same move again undoes it
+    void apply(const Move& move);
+
+private:
+    std::vector<int> tokens;
+    std::vector<int> operandPositions;
+    std::vector<int> operatorPositions;
+    std::vector<int> slot;              // Position -> index in operandPositions or operatorPositions
+    std::vector<int> operatorsThrough;  // Operators in tokens[0..i]
+    int equalOperatorPairs = 0;         // Adjacent equal operators
+
+    // Adjacent equal operators among tokens[begin..end]
+    int countEqualPairs(int begin, int end) const;
+
+    // Recomputes all maintained state and compares (O(n), checked builds)
+    bool checkInvariants() const;
+
+    Move drawOperandSwap() const;
+    Move drawChainComplement() const;
+    Move drawOperandOperatorSwap() const;
 };
 
 // Solution representation for the floorplan
@@ -107,8 +215,8 @@ public:
     const std::vector<int>& getPolishExpression() const;
     
     // Solution cost and validation
-    int getCost() const;
-    void setCost(int cost);
+    Area getCost() const;
+    void setCost(Area cost);
     bool isValid() const;
     
     // Apply floorplan to blocks
@@ -117,7 +225,7 @@ public:
 private:
     FloorplanData* data;
     std::vector<int> polishExpression;
-    int cost;
+    Area cost;
     
     // Build slicing tree from polish expression
     std::shared_ptr<SlicingTreeNode> buildSlicingTree();
@@ -8,6 +8,8 @@
 #include "solver.hpp"
 
 #include "../Logger.hpp"
+#include "../Profiler.hpp"
+#include "../ChromeTrace.hpp"
 /**
  * Initialize global placement debug logger
  */
@@ -51,25 +53,7 @@ void PlacementSolver::logContour() {
         return; // Early return if debugging is disabled
     }
     
-    std::stringstream ss;
-    ss << "Current contour: ";
-    
-    // Safely iterate through contour points
-    ContourPoint* current = contourHead;
-    int safetyCounter = 0; // Prevent infinite loops
-    const int maxPoints = 1000; // Reasonable upper limit
-    
-    while (current != nullptr && safetyCounter < maxPoints) {
-        ss << "(" << current->x << "," << current->height << ") ";
-        current = current->next;
-        safetyCounter++;
-    }
-    
-    if (safetyCounter >= maxPoints) {
-        ss << " [WARNING: Contour list may be corrupt - too many points]";
-    }
-    
-    logGlobalPlacement(ss.str());
+    logGlobalPlacement("Current contour: " + contour.toString());
 }
 
 /**
@@ -103,16 +87,17 @@ void PlacementSolver::printBStarTree(BStarNode* node, std::string prefix, bool i
 
 // Constructor
 PlacementSolver::PlacementSolver()
-    : bstarRoot(nullptr), contourHead(nullptr),
+    : bstarRoot(nullptr),
+      globalDebugEnabled(false),  // Initialize debug as disabled initially
       solutionArea(0), solutionWirelength(0),
-      bestSolutionArea(std::numeric_limits<int>::max()), bestSolutionWirelength(0),
+      bestSolutionArea(std::numeric_limits<Area>::max()), bestSolutionWirelength(0),
       initialTemperature(1000.0), finalTemperature(0.1),
       coolingRate(0.95), iterationsPerTemperature(100), noImprovementLimit(1000),
       rotateProb(0.3), moveProb(0.3), swapProb(0.3),
       changeRepProb(0.05), convertSymProb(0.05),
       areaWeight(1.0), wirelengthWeight(0.0),
       timeLimit(260),
-      globalDebugEnabled(false) {  // Initialize debug as disabled initially
+      placementEngine(PlacementEngine::SLICING) {
     
     // Initialize random number generator
     std::random_device rd;
@@ -125,7 +110,6 @@ PlacementSolver::PlacementSolver()
 // Destructor
 PlacementSolver::~PlacementSolver() {
     cleanupBStarTree(bstarRoot);
-    clearContour();
     
     // Close global log file if open
     if (globalLogFile.is_open()) {
@@ -142,115 +126,48 @@ void PlacementSolver::cleanupBStarTree(BStarNode* node) {
     delete node;
 }
 
-// Clear contour data structure
-void PlacementSolver::clearContour() {
-    while (contourHead != nullptr) {
-        ContourPoint* temp = contourHead;
-        contourHead = contourHead->next;
-        delete temp;
-    }
-    contourHead = nullptr;
+// Get height of contour at x-coordinate
+int PlacementSolver::getContourHeight(int x) {
+    return contour.heightAt(x);
 }
 
-// Update contour after placing a module
-void PlacementSolver::updateContour(int x, int y, int width, int height) {
-    int right = x + width;
-    int top = y + height;
-    
-    // Create a new contour point if contour is empty
-    if (contourHead == nullptr) {
-        contourHead = new ContourPoint(x, top);
-        contourHead->next = new ContourPoint(right, 0);
-        return;
+// Get dimensions of the module or island behind a node
+bool PlacementSolver::getNodeDimensions(BStarNode* node, int& width, int& height) {
+    if (node->isSymmetryIsland) {
+        // Extract island index from name (format: "island_X")
+        size_t islandIndex = std::stoi(node->name.substr(7));
+        if (islandIndex < symmetryIslands.size() && symmetryIslands[islandIndex]) {
+            width = symmetryIslands[islandIndex]->getWidth();
+            height = symmetryIslands[islandIndex]->getHeight();
+            return true;
+        }
+        logGlobalPlacement("ERROR: Invalid symmetry island: " + node->name);
+        return false;
     }
     
-    // Find the position to insert or update
-    ContourPoint* curr = contourHead;
-    ContourPoint* prev = nullptr;
-    
-    // Skip points to the left of the module
-    while (curr != nullptr && curr->x < x) {
-        prev = curr;
-        curr = curr->next;
+    if (auto module = findRegularModule(node->name)) {
+        width = module->getWidth();
+        height = module->getHeight();
+        return true;
     }
-    
-    // Update or insert points for the module
-    if (curr == nullptr || curr->x > right) {
-        // Module is beyond the current contour
-        ContourPoint* newPoint = new ContourPoint(x, top);
-        newPoint->next = new ContourPoint(right, prev ? prev->height : 0);
-        newPoint->next->next = curr;
-        
-        if (prev) {
-            prev->next = newPoint;
-        } else {
-            contourHead = newPoint;
+    logGlobalPlacement("ERROR: Regular module not found: " + node->name);
+    return false;
+}
+
+// Place the module or island behind a node
+void PlacementSolver::setNodePosition(BStarNode* node, int x, int y) {
+    if (node->isSymmetryIsland) {
+        size_t islandIndex = std::stoi(node->name.substr(7));
+        if (islandIndex < symmetryIslands.size() && symmetryIslands[islandIndex]) {
+            symmetryIslands[islandIndex]->setPosition(x, y);
         }
     } else {
-        // Module intersects with existing contour
-        if (curr->x > x) {
-            // Insert a new point at the left edge of the module
-            ContourPoint* newPoint = new ContourPoint(x, top);
-            newPoint->next = curr;
-            
-            if (prev) {
-                prev->next = newPoint;
-            } else {
-                contourHead = newPoint;
-            }
-            
-            prev = newPoint;
-        } else if (curr->x == x) {
-            // Update the existing point
-            curr->height = std::max(curr->height, top);
-            prev = curr;
-            curr = curr->next;
-        }
-        
-        // Update or merge intermediate points
-        while (curr != nullptr && curr->x <= right) {
-            if (curr->x == right) {
-                curr->height = std::max(curr->height, top);
-                break;
-            } else {
-                ContourPoint* temp = curr;
-                curr = curr->next;
-                delete temp;
-            }
-        }
-        
-        if (prev) {
-            prev->next = curr;
-        } else {
-            contourHead = curr;
-        }
-        
-        // If we reached the end without finding a point at 'right'
-        if (curr == nullptr || curr->x > right) {
-            ContourPoint* newPoint = new ContourPoint(right, prev ? prev->height : 0);
-            newPoint->next = curr;
-            
-            if (prev) {
-                prev->next = newPoint;
-            } else {
-                contourHead = newPoint;
-            }
+        if (auto module = findRegularModule(node->name)) {
+            module->setPosition(x, y);
         }
     }
 }
 
-// Get height of contour at x-coordinate
-int PlacementSolver::getContourHeight(int x) {
-    if (contourHead == nullptr) return 0;
-    
-    ContourPoint* curr = contourHead;
-    while (curr->next != nullptr && curr->next->x <= x) {
-        curr = curr->next;
-    }
-    
-    return curr->height;
-}
-
 /**
  * Builds a more balanced B*-tree for global placement
  * The key improvement is to generate a tree that uses both left and right children
@@ -298,26 +215,27 @@ void PlacementSolver::buildInitialBStarTree() {
     for (const auto& pair : regularModules) {
         // Skip null modules
         if (!pair.second) {
-            logGlobalPlacement("WARNING: nullptr found for module " + pair.first);
+            logGlobalPlacement("WARNING: nullptr found for module " + moduleName(pair.first));
             continue;
         }
+        const std::string& name = pair.second->getName();
         
         // Check if this is the clk module
-        if (pair.first == "clk") {
+        if (name == "clk") {
             hasClkModule = true;
-            clkModuleName = pair.first;
-            logGlobalPlacement("Found clk module: " + pair.first);
+            clkModuleName = name;
+            logGlobalPlacement("Found clk module: " + name);
         } else {
-            entities.push_back(pair.first);
+            entities.push_back(name);
         }
         
-        entityDimensions[pair.first] = {
+        entityDimensions[name] = {
             pair.second->getWidth(),
             pair.second->getHeight()
         };
-        isIslandMap[pair.first] = false;
+        isIslandMap[name] = false;
         
-        logGlobalPlacement("Adding regular module: " + pair.first + 
+        logGlobalPlacement("Adding regular module: " + name + 
                           " width=" + std::to_string(pair.second->getWidth()) + 
                           " height=" + std::to_string(pair.second->getHeight()));
     }
@@ -510,18 +428,19 @@ PlacementSolver::BStarNode* PlacementSolver::findNodeByName(const std::string& n
     return find(bstarRoot);
 }
 
-// Fixed packBStarTree function to properly handle BFS traversal
+// Global B*-tree nodes are labelled by name, since islands have no module id
+std::shared_ptr<Module> PlacementSolver::findRegularModule(const std::string& name) const {
+    auto it = regularModules.find(SymbolTable::modules().find(name));
+    return it == regularModules.end() ? nullptr : it->second;
+}
+
 /**
  * Pack the B*-tree to get the coordinates of all modules and islands
  * Ensures proper traversal of the tree structure to place all modules
  */
 void PlacementSolver::packBStarTree() {
-    // Clear the contour
-    clearContour();
-    
     if (globalDebugEnabled) {
         logGlobalPlacement("======== PACKING GLOBAL B*-TREE ========");
-        logContour();
     }
     
     // Validate tree structure before packing
@@ -534,197 +453,85 @@ void PlacementSolver::packBStarTree() {
         }
     }
     
-    // Initialize node positions
-    std::unordered_map<BStarNode*, std::pair<int, int>> nodePositions;
+    // Node geometry: x, y, width, height
+    struct NodePlacement {
+        int x, y, width, height;
+    };
+    std::unordered_map<BStarNode*, NodePlacement> placements;
     
-    // Use level-order traversal (BFS) to ensure parents are processed before children
-    std::queue<BStarNode*> bfsQueue;
-    // Track visited nodes to prevent processing the same node twice
+    // Level-order traversal (BFS) so parents are processed before children.
+    // X-coordinates only depend on the tree, so the first sweep fixes them
+    // and collects the contour breakpoints.
+    std::vector<BStarNode*> order;
     std::unordered_set<BStarNode*> visited;
+    contourBreakpoints.clear();
     
     if (bstarRoot != nullptr) {
-        bfsQueue.push(bstarRoot);
+        order.push_back(bstarRoot);
         visited.insert(bstarRoot);
-        
-        // Root is placed at (0,0)
-        nodePositions[bstarRoot] = {0, 0};
-        
-        // Update the module/island position
-        if (bstarRoot->isSymmetryIsland) {
-            // Extract island index from name (format: "island_X")
-            size_t islandIndex = std::stoi(bstarRoot->name.substr(7));
-            if (islandIndex < symmetryIslands.size()) {
-                symmetryIslands[islandIndex]->setPosition(0, 0);
-                updateContour(0, 0, 
-                             symmetryIslands[islandIndex]->getWidth(), 
-                             symmetryIslands[islandIndex]->getHeight());
-                
-                logGlobalPlacement("Placed root (island_" + std::to_string(islandIndex) + ") at (0,0)");
-            } else {
-                logGlobalPlacement("ERROR: Invalid island index for root: " + bstarRoot->name);
-            }
-        } else {
-            // Regular module
-            if (regularModules.find(bstarRoot->name) != regularModules.end()) {
-                regularModules[bstarRoot->name]->setPosition(0, 0);
-                updateContour(0, 0, 
-                             regularModules[bstarRoot->name]->getWidth(), 
-                             regularModules[bstarRoot->name]->getHeight());
-                
-                logGlobalPlacement("Placed root (" + bstarRoot->name + ") at (0,0)");
-            } else {
-                logGlobalPlacement("ERROR: Root module not found: " + bstarRoot->name);
-            }
-        }
+        placements[bstarRoot] = {0, 0, 0, 0};
     }
     
-    // Track the maximum x and y coordinates
-    int maxX = 0;
-    int maxY = 0;
-    
-    // Process the queue
-    while (!bfsQueue.empty()) {
-        BStarNode* node = bfsQueue.front();
-        bfsQueue.pop();
+    for (size_t head = 0; head < order.size(); head++) {
+        BStarNode* node = order[head];
+        NodePlacement& placement = placements[node];
         
-        // Skip null nodes
-        if (!node) {
-            logGlobalPlacement("WARNING: Encountered null node in BFS queue");
+        if (!getNodeDimensions(node, placement.width, placement.height)) {
             continue;
         }
         
-        logGlobalPlacement("Processing node: " + node->name);
-        
-        // Get current node position
-        int nodeX = nodePositions[node].first;
-        int nodeY = nodePositions[node].second;
-        
-        // Get current node dimensions
-        int width = 0;
-        int height = 0;
-        
-        if (node->isSymmetryIsland) {
-            // Extract island index
-            size_t islandIndex = std::stoi(node->name.substr(7));
-            if (islandIndex < symmetryIslands.size() && symmetryIslands[islandIndex]) {
-                width = symmetryIslands[islandIndex]->getWidth();
-                height = symmetryIslands[islandIndex]->getHeight();
-            } else {
-                logGlobalPlacement("ERROR: Invalid symmetry island: " + node->name);
-                continue;
-            }
-        } else {
-            // Regular module
-            if (regularModules.find(node->name) != regularModules.end() && 
-                regularModules[node->name]) {
-                width = regularModules[node->name]->getWidth();
-                height = regularModules[node->name]->getHeight();
-            } else {
-                logGlobalPlacement("ERROR: Regular module not found: " + node->name);
-                continue;
-            }
-        }
-        
-        // Update max coordinates
-        maxX = std::max(maxX, nodeX + width);
-        maxY = std::max(maxY, nodeY + height);
+        contourBreakpoints.push_back(placement.x);
+        contourBreakpoints.push_back(placement.x + placement.width);
         
-        // Process left child (placed to the right of current node)
+        // Left child is placed to the right of the current node
         if (node->left && visited.find(node->left) == visited.end()) {
-            int leftX = nodeX + width;
-            int leftY = nodeY;
-            
-            // Log before placing
-            logGlobalPlacement("Placing left child " + node->left->name + 
-                              " at (" + std::to_string(leftX) + "," + 
-                              std::to_string(leftY) + ")");
-            
-            // Store position of left child
-            nodePositions[node->left] = {leftX, leftY};
             visited.insert(node->left);
-            
-            // Update module/island position
-            if (node->left->isSymmetryIsland) {
-                // Symmetry island
-                size_t islandIndex = std::stoi(node->left->name.substr(7));
-                if (islandIndex < symmetryIslands.size() && symmetryIslands[islandIndex]) {
-                    symmetryIslands[islandIndex]->setPosition(leftX, leftY);
-                    updateContour(leftX, leftY, 
-                                 symmetryIslands[islandIndex]->getWidth(), 
-                                 symmetryIslands[islandIndex]->getHeight());
-                } else {
-                    logGlobalPlacement("ERROR: Invalid symmetry island for left child: " + node->left->name);
-                }
-            } else {
-                // Regular module
-                if (regularModules.find(node->left->name) != regularModules.end() && 
-                    regularModules[node->left->name]) {
-                    regularModules[node->left->name]->setPosition(leftX, leftY);
-                    updateContour(leftX, leftY, 
-                                 regularModules[node->left->name]->getWidth(), 
-                                 regularModules[node->left->name]->getHeight());
-                } else {
-                    logGlobalPlacement("ERROR: Regular module not found for left child: " + node->left->name);
-                }
-            }
-            
-            // Add to queue for further processing
-            bfsQueue.push(node->left);
+            placements[node->left] = {placement.x + placement.width, 0, 0, 0};
+            order.push_back(node->left);
         } else if (node->left) {
             logGlobalPlacement("WARNING: Left child " + node->left->name + 
                               " has already been visited (cycle detected)");
         }
         
-        // Process right child (placed at same x, above current node)
+        // Right child is placed at the same x, above the current node
         if (node->right && visited.find(node->right) == visited.end()) {
-            int rightX = nodeX;
-            int rightY = nodeY + height;
-            
-            // Log before placing
-            logGlobalPlacement("Placing right child " + node->right->name + 
-                              " at (" + std::to_string(rightX) + "," + 
-                              std::to_string(rightY) + ")");
-            
-            // Store position of right child
-            nodePositions[node->right] = {rightX, rightY};
             visited.insert(node->right);
-            
-            // Update module/island position
-            if (node->right->isSymmetryIsland) {
-                // Symmetry island
-                size_t islandIndex = std::stoi(node->right->name.substr(7));
-                if (islandIndex < symmetryIslands.size() && symmetryIslands[islandIndex]) {
-                    symmetryIslands[islandIndex]->setPosition(rightX, rightY);
-                    updateContour(rightX, rightY, 
-                                 symmetryIslands[islandIndex]->getWidth(), 
-                                 symmetryIslands[islandIndex]->getHeight());
-                } else {
-                    logGlobalPlacement("ERROR: Invalid symmetry island for right child: " + node->right->name);
-                }
-            } else {
-                // Regular module
-                if (regularModules.find(node->right->name) != regularModules.end() && 
-                    regularModules[node->right->name]) {
-                    regularModules[node->right->name]->setPosition(rightX, rightY);
-                    updateContour(rightX, rightY, 
-                                 regularModules[node->right->name]->getWidth(), 
-                                 regularModules[node->right->name]->getHeight());
-                } else {
-                    logGlobalPlacement("ERROR: Regular module not found for right child: " + node->right->name);
-                }
-            }
-            
-            // Add to queue for further processing
-            bfsQueue.push(node->right);
+            placements[node->right] = {placement.x, 0, 0, 0};
+            order.push_back(node->right);
         } else if (node->right) {
             logGlobalPlacement("WARNING: Right child " + node->right->name + 
                               " has already been visited (cycle detected)");
         }
-        
-        // Log the current contour
-        if (globalDebugEnabled) {
-            logContour();
+    }
+    
+    contour.reset(contourBreakpoints);
+    
+    // Track the maximum x and y coordinates
+    int maxX = 0;
+    int maxY = 0;
+    
+    // Second sweep: drop every node onto the contour over its x-span
+    for (BStarNode* node : order) {
+        NodePlacement& placement = placements[node];
+        if (placement.width == 0 && placement.height == 0) {
+            continue; // Unknown module, already reported
         }
+        
+        int right = placement.x + placement.width;
+        placement.y = contour.maxHeight(placement.x, right);
+        contour.assign(placement.x, right, placement.y + placement.height);
+        
+        setNodePosition(node, placement.x, placement.y);
+        
+        logGlobalPlacement("Placed " + node->name + " at (" + std::to_string(placement.x) + "," + 
+                          std::to_string(placement.y) + ")");
+        
+        maxX = std::max(maxX, right);
+        maxY = std::max(maxY, placement.y + placement.height);
+    }
+    
+    if (globalDebugEnabled) {
+        logContour();
     }
     
     // Count how many nodes were visited vs how many should be in the tree
@@ -742,7 +549,7 @@ void PlacementSolver::packBStarTree() {
     
     // Log the resulting bounding box
     logGlobalPlacement("Final bounding box: (" + std::to_string(maxX) + "," + 
-                      std::to_string(maxY) + ") with area " + std::to_string(maxX * maxY));
+                      std::to_string(maxY) + ") with area " + std::to_string(areaOf(maxX, maxY)));
     
     // Update traversal lists with names instead of pointers
     preorderNodeNames.clear();
@@ -756,43 +563,88 @@ void PlacementSolver::packBStarTree() {
     }
 }
 
-// Calculate bounding box area
-int PlacementSolver::calculateArea() {
-    int minX = 0;
-    int minY = 0;
-    int maxX = 0;
-    int maxY = 0;
+// Calculate bounding box
+void PlacementSolver::calculateBoundingBox(int& width, int& height) {
+    width = 0;
+    height = 0;
     
-    // Check symmetry islands
-    for (const auto& island : symmetryIslands) {
-        maxX = std::max(maxX, island->getX() + island->getWidth());
-        maxY = std::max(maxY, island->getY() + island->getHeight());
+    // Island modules follow their island, so one scan over all module
+    // geometry covers regular modules and islands alike
+    if (moduleGeometry) {
+        moduleGeometry->getExtent(width, height);
     }
+}
+
+// Calculate bounding box area
+Area PlacementSolver::calculateArea() {
+    int width, height;
+    calculateBoundingBox(width, height);
+    return areaOf(width, height);
+}
+
+// Calculate half-perimeter wirelength
+double PlacementSolver::calculateWirelength() {
+    if (moduleWirelength.empty()) return 0.0;
     
-    // Check regular modules
-    for (const auto& pair : regularModules) {
-        const auto& module = pair.second;
-        maxX = std::max(maxX, module->getX() + module->getWidth());
-        maxY = std::max(maxY, module->getY() + module->getHeight());
+    // Unmoved modules are skipped by the evaluator, so only nets on moved
+    // modules are recomputed
+    for (size_t i = 0; i < wirelengthModules.size(); i++) {
+        const auto& module = wirelengthModules[i];
+        moduleWirelength.moveObject(static_cast<int>(i), module->getX(), module->getY(), module->getRotated());
     }
     
-    return maxX * maxY;
+    return moduleWirelength.evaluate();
 }
 
-// Calculate half-perimeter wirelength (placeholder)
-double PlacementSolver::calculateWirelength() {
-    // This is a placeholder - in a real implementation, you would calculate
-    // the wirelength based on module connectivity information
+// Build the wirelength model over slicing blocks
+void PlacementSolver::buildBlockWirelengthModel(
+    HPWLEvaluator& model, int numBlocks,
+    const std::vector<int>& islandBlocks,
+    const std::vector<int>& moduleBlocks) {
+    
+    // Block index and module offset within the block, by module id
+    struct PinHost {
+        int block;
+        int originX;
+        int originY;
+    };
+    std::vector<PinHost> hosts(SymbolTable::modules().size(), {-1, 0, 0});
     
-    // For this simplified version, we'll use a proxy: sum of distances from modules to the origin
-    double wirelength = 0.0;
+    for (size_t i = 0; i < symmetryIslands.size() && i < islandBlocks.size(); i++) {
+        const auto& island = symmetryIslands[i];
+        for (const auto& pair : island->getASFBStarTree()->getModules()) {
+            auto relPos = island->getRelativePosition(pair.first);
+            hosts[pair.first] = {islandBlocks[i], relPos.first, relPos.second};
+        }
+    }
+    for (size_t id = 0; id < moduleBlocks.size() && id < hosts.size(); id++) {
+        if (moduleBlocks[id] >= 0) hosts[id] = {moduleBlocks[id], 0, 0};
+    }
     
-    return wirelength;
+    model.reset(numBlocks);
+    for (const auto& net : nets) {
+        int netId = model.addNet();
+        for (const auto& pin : net.pins) {
+            auto moduleIt = modules.find(pin.module);
+            if (moduleIt == modules.end() || hosts[pin.module].block < 0) continue;
+            
+            const auto& module = moduleIt->second;
+            const PinHost& host = hosts[pin.module];
+            
+            // Pin offsets are given in the module's unrotated frame
+            int dx = module->getRotated() ? pin.offsetY : pin.offsetX;
+            int dy = module->getRotated() ? pin.offsetX : pin.offsetY;
+            model.addPin(netId, host.block,
+                         2 * host.originX + module->getWidth() + 2 * dx,
+                         2 * host.originY + module->getHeight() + 2 * dy);
+        }
+    }
+    model.finalize();
 }
 
 // Calculate cost of current solution
 double PlacementSolver::calculateCost() {
-    int area = calculateArea();
+    Area area = calculateArea();
     double wirelength = calculateWirelength();
     
     return areaWeight * area + wirelengthWeight * wirelength;
@@ -854,8 +706,8 @@ bool PlacementSolver::rotateModule(bool isSymmetryIsland, const std::string& nam
         }
     } else {
         // Rotate a regular module
-        if (regularModules.find(name) != regularModules.end()) {
-            regularModules[name]->rotate();
+        if (auto module = findRegularModule(name)) {
+            module->rotate();
             return true;
         }
     }
@@ -1159,7 +1011,7 @@ bool PlacementSolver::validateBStarTree() {
             }
         } else {
             // Check if module exists
-            if (regularModules.find(n->name) == regularModules.end() || !regularModules[n->name]) {
+            if (!findRegularModule(n->name)) {
                 logGlobalPlacement("Tree validation FAILED: Node " + n->name + " references invalid regular module");
                 return false;
             }
@@ -1269,178 +1121,121 @@ void PlacementSolver::restoreBStarTree() {
 bool PlacementSolver::hasOverlaps() {
     logGlobalPlacement("======== CHECKING FOR MODULE OVERLAPS ========");
     
-    // Define a helper function to log module bounds safely
-    auto logModuleBounds = [this](const std::string& name, int x, int y, int width, int height) {
-        std::stringstream ss;
-        ss << name << ": (" << x << "," << y << ") to (" 
-           << (x + width) << "," << (y + height) << ") [" 
-           << width << "x" << height << "]";
-        logGlobalPlacement(ss.str());
-    };
-    
-    // Check overlaps between regular modules
-    logGlobalPlacement("--- Regular Module vs Regular Module Checks ---");
-    for (const auto& pair1 : regularModules) {
-        const auto& name1 = pair1.first;
-        const auto& module1 = pair1.second;
-        
-        // Skip null modules
-        if (!module1) {
-            logGlobalPlacement("WARNING: nullptr found for module " + name1);
-            continue;
-        }
-        
-        int m1Left = module1->getX();
-        int m1Right = m1Left + module1->getWidth();
-        int m1Bottom = module1->getY();
-        int m1Top = m1Bottom + module1->getHeight();
-        
-        logModuleBounds(name1, m1Left, m1Bottom, module1->getWidth(), module1->getHeight());
-        
-        // Check against other regular modules
-        for (const auto& pair2 : regularModules) {
-            const auto& name2 = pair2.first;
-            if (name1 == name2) continue; // Skip self
-            
-            const auto& module2 = pair2.second;
-            
-            // Skip null modules
-            if (!module2) {
-                logGlobalPlacement("WARNING: nullptr found for module " + name2);
-                continue;
-            }
-            
-            int m2Left = module2->getX();
-            int m2Right = m2Left + module2->getWidth();
-            int m2Bottom = module2->getY();
-            int m2Top = m2Bottom + module2->getHeight();
-            
-            bool xOverlap = m1Right > m2Left && m2Right > m1Left;
-            bool yOverlap = m1Top > m2Bottom && m2Top > m1Bottom;
-            bool overlaps = xOverlap && yOverlap;
-            
-            if (overlaps) {
-                std::stringstream ss;
-                ss << "OVERLAP DETECTED: " << name1 << " and " << name2;
-                logGlobalPlacement(ss.str());
-                logModuleBounds(name2, m2Left, m2Bottom, module2->getWidth(), module2->getHeight());
-                return true;
-            }
-        }
+    loadOverlapDetector();
+    if (!overlapDetector.hasOverlap()) {
+        logGlobalPlacement("No overlaps detected");
+        return false;
     }
     
-    // Check overlaps between regular modules and symmetry islands
-    logGlobalPlacement("--- Regular Module vs Symmetry Island Checks ---");
+    const auto& pair = overlapDetector.findOverlaps().front();
+    std::stringstream ss;
+    ss << "OVERLAP DETECTED: " << getOverlapEntityName(pair.first)
+       << " and " << getOverlapEntityName(pair.second);
+    logGlobalPlacement(ss.str());
+    return true;
+}
+
+// Fill the overlap detector with all regular modules and symmetry islands
+void PlacementSolver::loadOverlapDetector() {
+    overlapModules.clear();
     for (const auto& pair : regularModules) {
-        const auto& name = pair.first;
-        const auto& module = pair.second;
-        
-        // Skip null modules
-        if (!module) {
-            logGlobalPlacement("WARNING: nullptr found for module " + name);
-            continue;
-        }
-        
-        int mLeft = module->getX();
-        int mRight = mLeft + module->getWidth();
-        int mBottom = module->getY();
-        int mTop = mBottom + module->getHeight();
-        
-        logModuleBounds(name, mLeft, mBottom, module->getWidth(), module->getHeight());
-        
-        // Check against all symmetry islands
-        for (size_t i = 0; i < symmetryIslands.size(); i++) {
-            const auto& island = symmetryIslands[i];
-            
-            // Skip null islands
-            if (!island) {
-                logGlobalPlacement("WARNING: nullptr found for island " + std::to_string(i));
-                continue;
-            }
-            
-            std::string islandName = "island_" + std::to_string(i);
-            
-            int islandLeft = island->getX();
-            int islandRight = islandLeft + island->getWidth();
-            int islandBottom = island->getY();
-            int islandTop = islandBottom + island->getHeight();
-            
-            logModuleBounds(islandName, islandLeft, islandBottom, island->getWidth(), island->getHeight());
-            
-            bool xOverlap = mRight > islandLeft && islandRight > mLeft;
-            bool yOverlap = mTop > islandBottom && islandTop > mBottom;
-            bool overlaps = xOverlap && yOverlap;
-            
-            if (overlaps) {
-                std::stringstream ss;
-                ss << "OVERLAP DETECTED: " << name << " and " << islandName;
-                logGlobalPlacement(ss.str());
-                return true;
-            }
-        }
+        if (pair.second) overlapModules.push_back(pair.second);
     }
     
-    // Check overlaps between symmetry islands
-    logGlobalPlacement("--- Symmetry Island vs Symmetry Island Checks ---");
-    for (size_t i = 0; i < symmetryIslands.size(); i++) {
-        for (size_t j = i + 1; j < symmetryIslands.size(); j++) {
-            const auto& island1 = symmetryIslands[i];
-            const auto& island2 = symmetryIslands[j];
-            
-            // Skip null islands
-            if (!island1 || !island2) {
-                logGlobalPlacement("WARNING: nullptr found for islands " + 
-                                  std::to_string(i) + " or " + std::to_string(j));
-                continue;
-            }
-            
-            std::string islandName1 = "island_" + std::to_string(i);
-            std::string islandName2 = "island_" + std::to_string(j);
-            
-            int i1Left = island1->getX();
-            int i1Right = i1Left + island1->getWidth();
-            int i1Bottom = island1->getY();
-            int i1Top = i1Bottom + island1->getHeight();
-            
-            int i2Left = island2->getX();
-            int i2Right = i2Left + island2->getWidth();
-            int i2Bottom = island2->getY();
-            int i2Top = i2Bottom + island2->getHeight();
-            
-            logModuleBounds(islandName1, i1Left, i1Bottom, island1->getWidth(), island1->getHeight());
-            logModuleBounds(islandName2, i2Left, i2Bottom, island2->getWidth(), island2->getHeight());
-            
-            bool xOverlap = i1Right > i2Left && i2Right > i1Left;
-            bool yOverlap = i1Top > i2Bottom && i2Top > i1Bottom;
-            bool overlaps = xOverlap && yOverlap;
-            
-            if (overlaps) {
-                std::stringstream ss;
-                ss << "OVERLAP DETECTED: " << islandName1 << " and " << islandName2;
-                logGlobalPlacement(ss.str());
-                return true;
-            }
+    overlapDetector.clear();
+    for (size_t i = 0; i < overlapModules.size() + symmetryIslands.size(); i++) {
+        int x, y, width, height;
+        if (getOverlapEntityRect(static_cast<int>(i), x, y, width, height)) {
+            overlapDetector.addRect(static_cast<int>(i), x, y, width, height);
         }
     }
-    
-    logGlobalPlacement("No overlaps detected");
+}
+
+bool PlacementSolver::getOverlapEntityRect(int id, int& x, int& y, int& width, int& height) const {
+    size_t index = static_cast<size_t>(id);
+    if (index < overlapModules.size()) {
+        const auto& module = overlapModules[index];
+        x = module->getX();
+        y = module->getY();
+        width = module->getWidth();
+        height = module->getHeight();
+        return true;
+    }
+    
+    index -= overlapModules.size();
+    if (index < symmetryIslands.size() && symmetryIslands[index]) {
+        const auto& island = symmetryIslands[index];
+        x = island->getX();
+        y = island->getY();
+        width = island->getWidth();
+        height = island->getHeight();
+        return true;
+    }
     return false;
 }
 
+void PlacementSolver::setOverlapEntityPosition(int id, int x, int y) {
+    size_t index = static_cast<size_t>(id);
+    if (index < overlapModules.size()) {
+        overlapModules[index]->setPosition(x, y);
+    } else if (index - overlapModules.size() < symmetryIslands.size()) {
+        symmetryIslands[index - overlapModules.size()]->setPosition(x, y);
+    }
+}
 
-// Deep copy of module data
-std::map<std::string, std::shared_ptr<Module>> PlacementSolver::copyModules(
-    const std::map<std::string, std::shared_ptr<Module>>& source) {
+bool PlacementSolver::compactPlacement() {
+    ChromeTrace::Scope trace("compactPlacement", "legalize");
+    loadOverlapDetector();
+    if (overlapDetector.hasOverlap()) {
+        Logger::log("Skipping compaction: placement has overlaps");
+        return false;
+    }
     
-    std::map<std::string, std::shared_ptr<Module>> result;
+    compactor.clear();
+    std::vector<std::pair<int, int>> original;
+    for (size_t i = 0; i < overlapModules.size() + symmetryIslands.size(); i++) {
+        int x, y, width, height;
+        if (getOverlapEntityRect(static_cast<int>(i), x, y, width, height)) {
+            compactor.addRect(static_cast<int>(i), x, y, width, height);
+            original.emplace_back(x, y);
+        }
+    }
     
-    for (const auto& pair : source) {
-        result[pair.first] = std::make_shared<Module>(*pair.second);
+    Area areaBefore = calculateArea();
+    double costBefore = calculateCost();
+    if (!compactor.compact()) {
+        return false;
     }
     
-    return result;
+    for (size_t i = 0; i < compactor.size(); i++) {
+        setOverlapEntityPosition(compactor.getId(i), compactor.getX(i), compactor.getY(i));
+    }
+    
+    // Moving left and down cannot grow the area but may stretch nets
+    if (calculateCost() > costBefore) {
+        for (size_t i = 0; i < compactor.size(); i++) {
+            setOverlapEntityPosition(compactor.getId(i), original[i].first, original[i].second);
+        }
+        calculateWirelength();
+        Logger::log("Compaction rejected: cost would increase");
+        return false;
+    }
+    
+    Logger::log("Compaction: area " + std::to_string(areaBefore) + " -> " +
+        std::to_string(calculateArea()) + " (" + std::to_string(compactor.getEdgeCount()) +
+        " constraint edges for " + std::to_string(compactor.size()) + " blocks)");
+    return true;
 }
 
+std::string PlacementSolver::getOverlapEntityName(int id) const {
+    size_t index = static_cast<size_t>(id);
+    if (index < overlapModules.size()) {
+        return overlapModules[index]->getName();
+    }
+    return "island_" + std::to_string(index - overlapModules.size());
+}
+
+
 // Find a random node in the B*-tree
 PlacementSolver::BStarNode* PlacementSolver::findRandomNode() {
     if (preorderTraversal.empty()) {
@@ -1452,48 +1247,28 @@ PlacementSolver::BStarNode* PlacementSolver::findRandomNode() {
 
 // Copy current solution to best solution
 void PlacementSolver::updateBestSolution() {
+    HW4_PROFILE_SCOPE("PlacementSolver::updateBestSolution");
     bestSolutionArea = solutionArea;
     bestSolutionWirelength = solutionWirelength;
     
-    // Update all modules in the solution
-    bestSolutionModules.clear();
+    if (!moduleGeometry) return;
     
-    // Add regular modules
-    for (const auto& pair : regularModules) {
-        bestSolutionModules[pair.first] = std::make_shared<Module>(*pair.second);
-    }
-    
-    // Add modules from symmetry islands
-    for (const auto& island : symmetryIslands) {
-        for (const auto& pair : island->getASFBStarTree()->getModules()) {
-            bestSolutionModules[pair.first] = std::make_shared<Module>(*pair.second);
-        }
-    }
+    // Regular and island modules alike; same size, so assign() reuses the storage
+    const auto& xs = moduleGeometry->getXs();
+    const auto& ys = moduleGeometry->getYs();
+    const auto& rotations = moduleGeometry->getRotations();
+    bestPlacement.x.assign(xs.begin(), xs.end());
+    bestPlacement.y.assign(ys.begin(), ys.end());
+    bestPlacement.rotated.assign(rotations.begin(), rotations.end());
+    bestPlacement.generation++;
 }
 
 // Copy best solution to current solution
 void PlacementSolver::restoreBestSolution() {
-    // Restore module positions from best solution
-    for (const auto& pair : bestSolutionModules) {
-        const std::string& name = pair.first;
-        const auto& module = pair.second;
-        
-        // Check if it's a regular module
-        if (regularModules.find(name) != regularModules.end()) {
-            regularModules[name]->setPosition(module->getX(), module->getY());
-            regularModules[name]->setRotation(module->getRotated());
-        } else {
-            // It's in a symmetry island - find and update it
-            for (const auto& island : symmetryIslands) {
-                const auto& islandModules = island->getASFBStarTree()->getModules();
-                if (islandModules.find(name) != islandModules.end()) {
-                    islandModules.at(name)->setPosition(module->getX(), module->getY());
-                    islandModules.at(name)->setRotation(module->getRotated());
-                    break;
-                }
-            }
-        }
-    }
+    if (!moduleGeometry || bestPlacement.generation == 0) return;
+    
+    moduleGeometry->setPlacement(bestPlacement.x.data(), bestPlacement.y.data(),
+                                 bestPlacement.rotated.data());
     
     // Update solution metrics
     solutionArea = bestSolutionArea;
@@ -1502,22 +1277,56 @@ void PlacementSolver::restoreBestSolution() {
 
 // Load the problem data
 bool PlacementSolver::loadProblem(
-    const std::map<std::string, std::shared_ptr<Module>>& modules,
-    const std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups) {
+    const std::map<ModuleId, std::shared_ptr<Module>>& modules,
+    const std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups,
+    const std::vector<Net>& nets) {
+    HW4_PROFILE_SCOPE("PlacementSolver::loadProblem");
+    ChromeTrace::Scope trace("loadProblem", "solver");
     
     // Clear current data
     this->modules = modules;
     this->symmetryGroups = symmetryGroups;
+    this->nets = nets;
+    
+    // The parser puts all modules into one store
+    moduleGeometry = modules.empty() ? nullptr : modules.begin()->second->getGeometry();
+    bestPlacement.resize(moduleGeometry ? moduleGeometry->size() : 0);
+    
+    // Module-level wirelength model; pins sit at module centers plus offset
+    std::unordered_map<ModuleId, int> moduleIds;
+    wirelengthModules.clear();
+    for (const auto& pair : modules) {
+        moduleIds[pair.first] = static_cast<int>(wirelengthModules.size());
+        wirelengthModules.push_back(pair.second);
+    }
+    moduleWirelength.reset(wirelengthModules.size());
+    for (const auto& net : nets) {
+        int netId = moduleWirelength.addNet();
+        for (const auto& pin : net.pins) {
+            auto idIt = moduleIds.find(pin.module);
+            if (idIt == moduleIds.end()) continue;
+            const auto& module = modules.at(pin.module);
+            moduleWirelength.addPin(netId, idIt->second,
+                                    module->getOriginalWidth() + 2 * pin.offsetX,
+                                    module->getOriginalHeight() + 2 * pin.offsetY);
+        }
+    }
+    moduleWirelength.finalize();
     
     regularModules.clear();
     symmetryIslands.clear();
     
+    if (!islandLibraryPath.empty() && !islandLibrary.load(islandLibraryPath)) {
+        std::cerr << "Warning: ignoring unreadable island library " << islandLibraryPath << std::endl;
+    }
+    int libraryHits = 0;
+    
     // Create symmetry islands
     for (size_t i = 0; i < symmetryGroups.size(); i++) {
         auto symmetryGroup = symmetryGroups[i];
         
         // Collect modules in this symmetry group
-        std::map<std::string, std::shared_ptr<Module>> groupModules;
+        std::map<ModuleId, std::shared_ptr<Module>> groupModules;
         
         // Add symmetry pairs
         for (const auto& pair : symmetryGroup->getSymmetryPairs()) {
@@ -1530,37 +1339,80 @@ bool PlacementSolver::loadProblem(
         }
         
         // Add self-symmetric modules
-        for (const auto& name : symmetryGroup->getSelfSymmetric()) {
-            if (modules.find(name) != modules.end()) {
-                groupModules[name] = modules.at(name);
+        for (ModuleId id : symmetryGroup->getSelfSymmetric()) {
+            if (modules.find(id) != modules.end()) {
+                groupModules[id] = modules.at(id);
             }
         }
         
         // Create ASF-B*-tree for this symmetry group
         auto asfBStarTree = std::make_shared<ASFBStarTree>(symmetryGroup, groupModules);
         
-        // Pack the ASF-B*-tree to get initial layout
-        asfBStarTree->pack();
+        // Reuse a cached layout of an identical group if there is one
+        uint64_t libraryKey = 0;
+        bool fromLibrary = false;
+        if (!islandLibraryPath.empty()) {
+            libraryKey = IslandLibrary::computeKey(*symmetryGroup, modules);
+            const IslandShape* shape = islandLibrary.find(libraryKey);
+            if (shape && shape->type == symmetryGroup->getType() &&
+                IslandLibrary::apply(*shape, groupModules)) {
+                asfBStarTree->setSymmetryAxisPosition(shape->axisPosition);
+                
+                // A stale or corrupt entry is repacked (and replaced) instead
+                if (asfBStarTree->validatePlacement()) {
+                    fromLibrary = true;
+                    libraryHits++;
+                } else {
+                    std::cerr << "Warning: ignoring invalid cached layout for symmetry group "
+                              << symmetryGroup->getName() << std::endl;
+                }
+            }
+        }
+        
+        bool packed = fromLibrary;
+        if (!fromLibrary) {
+            // Pack the ASF-B*-tree to get initial layout
+            packed = asfBStarTree->pack();
+        }
+        if (!asfBStarTree->hasExactSymmetry()) {
+            std::cerr << "Error: symmetry group " << symmetryGroup->getName()
+                      << " has self-symmetric modules whose lengths differ in parity in every orientation;"
+                      << " they are centered to within half a unit of the axis" << std::endl;
+        }
         
         // Create symmetry island
-        auto island = std::make_shared<SymmetryIslandBlock>("sg_" + std::to_string(i), asfBStarTree);
+        auto island = std::make_shared<SymmetryIslandBlock>("sg_" + std::to_string(i), asfBStarTree, fromLibrary);
         
         // Update bounding box
         island->updateBoundingBox();
         
+        // Only layouts that passed validation go into the library
+        if (!islandLibraryPath.empty() && !fromLibrary && packed) {
+            islandLibrary.store(libraryKey, symmetryGroup->getType(), groupModules,
+                                asfBStarTree->getSymmetryAxisPosition());
+        }
+        
         symmetryIslands.push_back(island);
     }
     
+    if (!islandLibraryPath.empty()) {
+        std::cout << "Island library: " << libraryHits << " of " << symmetryGroups.size()
+                  << " islands reused" << std::endl;
+        if (!islandLibrary.save(islandLibraryPath)) {
+            std::cerr << "Warning: could not write island library " << islandLibraryPath << std::endl;
+        }
+    }
+    
     // Collect regular modules (not in any symmetry group)
-    std::unordered_set<std::string> symmetryModules;
+    std::unordered_set<ModuleId> symmetryModules;
     
     for (const auto& group : symmetryGroups) {
         for (const auto& pair : group->getSymmetryPairs()) {
             symmetryModules.insert(pair.first);
             symmetryModules.insert(pair.second);
         }
-        for (const auto& name : group->getSelfSymmetric()) {
-            symmetryModules.insert(name);
+        for (ModuleId id : group->getSelfSymmetric()) {
+            symmetryModules.insert(id);
         }
     }
     
@@ -1617,8 +1469,24 @@ void PlacementSolver::setTimeLimit(int seconds) {
     timeLimit = seconds;
 }
 
+// Set global placement engine
+void PlacementSolver::setPlacementEngine(PlacementEngine engine) {
+    placementEngine = engine;
+}
+
+// Set fixed outline
+void PlacementSolver::setFixedOutline(int width, int height) {
+    outline = Outline(width, height);
+}
+
+// Set island library path
+void PlacementSolver::setIslandLibraryPath(const std::string& path) {
+    islandLibraryPath = path;
+}
+
 // Solve the placement problem
 bool PlacementSolver::solve() {
+    ChromeTrace::Scope trace("solve", "solver");
     try {
         // Record start time
         startTime = std::chrono::steady_clock::now();
@@ -1631,13 +1499,21 @@ bool PlacementSolver::solve() {
          * PHASE 1: Initialize symmetry islands using ASF-B*-trees
          ********************************************************************/
         Logger::log("PHASE 1: Initializing symmetry islands");
+        HW4_PROFILE_STAGE(phase, "PlacementSolver::solve/phase 1 islands");
         
         // Build ASF-B*-trees for each symmetry group
         for (size_t i = 0; i < symmetryIslands.size(); i++) {
             auto island = symmetryIslands[i];
             if (!island) continue;
             
+            // Islands taken from the library already hold their final layout
+            if (island->isFromLibrary()) {
+                Logger::log("Using cached layout for symmetry island " + std::to_string(i));
+                continue;
+            }
+            
             // Pack the ASF-B*-tree to get internal layout for the symmetry island
+            ChromeTrace::Scope islandTrace("pack island", "islands", "island", static_cast<long long>(i));
             Logger::log("Packing ASF-B*-tree for symmetry island " + std::to_string(i));
             if (!island->getASFBStarTree()->pack()) {
                 Logger::log("ERROR: Failed to pack ASF-B*-tree for symmetry island " + std::to_string(i));
@@ -1657,15 +1533,15 @@ bool PlacementSolver::solve() {
          * PHASE 2: Create SlicingPlacementSolver and initialize data
          ********************************************************************/
         Logger::log("PHASE 2: Setting up slicing-based global placement");
+        HW4_PROFILE_NEXT_STAGE(phase, "PlacementSolver::solve/phase 2 setup");
         
         // Create the FloorplanData for slicing
         std::unique_ptr<FloorplanData> floorplanData = std::make_unique<FloorplanData>();
-        // No fixed outline for analog placement
-        floorplanData->setFloorplanDimensions(std::numeric_limits<int>::max(), 
-                                             std::numeric_limits<int>::max());
+        // Unbounded unless a fixed outline was set
+        floorplanData->setFloorplanDimensions(outline.width, outline.height);
         
         // Mapping between slicing blocks and original modules/islands
-        std::unordered_map<int, std::pair<bool, size_t>> blockMapping; // <blockIdx, <isIsland, moduleIdx>>
+        std::vector<std::pair<bool, size_t>> blockMapping; // Per block: <isIsland, island index or module id>
         int blockIndex = 0;
         
         // Add symmetry islands as blocks to the FloorplanData
@@ -1674,11 +1550,11 @@ bool PlacementSolver::solve() {
             if (!island) continue;
             
             std::string name = "island_" + std::to_string(i);
-            Block* block = new Block(name, island->getWidth(), island->getHeight());
-            floorplanData->addBlock(block);
+            floorplanData->addBlock(name, island->getWidth(), island->getHeight());
             
             // Store mapping: this block represents symmetry island i
-            blockMapping[blockIndex++] = {true, i};
+            blockMapping.push_back({true, i});
+            blockIndex++;
             
             Logger::log("Added symmetry island " + std::to_string(i) + " as block " + 
                 std::to_string(blockIndex-1) + " with dimensions " + 
@@ -1688,54 +1564,112 @@ bool PlacementSolver::solve() {
         
         // Add regular modules as blocks
         for (const auto& pair : regularModules) {
-            const auto& moduleName = pair.first;
             const auto& module = pair.second;
             if (!module) continue;
             
-            Block* block = new Block(moduleName, module->getWidth(), module->getHeight());
-            floorplanData->addBlock(block);
+            // The block views the module's own geometry, so the engine places
+            // the module directly; it starts unrotated at the origin
+            module->setRotation(false);
+            module->setPosition(0, 0);
+            floorplanData->addBlock(module->getName(), module->getGeometry().get(), static_cast<int>(pair.first));
             
-            // Store mapping: this block represents regular module with name moduleName
-            // Store the index in the regularModules map using distance
-            size_t moduleIdx = std::distance(regularModules.begin(), regularModules.find(moduleName));
-            blockMapping[blockIndex++] = {false, moduleIdx};
+            // Store mapping: this block represents the regular module with this id
+            blockMapping.push_back({false, pair.first});
+            blockIndex++;
             
-            Logger::log("Added regular module " + moduleName + " as block " + 
+            Logger::log("Added regular module " + module->getName() + " as block " + 
                 std::to_string(blockIndex-1) + " with dimensions " + 
                 std::to_string(module->getWidth()) + "x" + 
                 std::to_string(module->getHeight()));
         }
         
-        // Create and configure Simulated Annealing solver for slicing
-        auto optimizer = std::make_unique<SimulatedAnnealing>(floorplanData.get());
+        // Wirelength term: every pin rides on its module's slicing block
+        HPWLEvaluator blockWirelength;
+        bool useWirelength = !nets.empty() && wirelengthWeight > 0.0;
+        if (useWirelength) {
+            std::vector<int> islandBlocks(symmetryIslands.size(), -1);
+            std::vector<int> moduleBlocks(SymbolTable::modules().size(), -1);
+            for (size_t block = 0; block < blockMapping.size(); block++) {
+                if (blockMapping[block].first) {
+                    islandBlocks[blockMapping[block].second] = static_cast<int>(block);
+                } else {
+                    moduleBlocks[blockMapping[block].second] = static_cast<int>(block);
+                }
+            }
+            buildBlockWirelengthModel(blockWirelength, floorplanData->getNumBlocks(), islandBlocks, moduleBlocks);
+            
+            Logger::log("Wirelength-aware cost with " + std::to_string(blockWirelength.getNumNets()) +
+                " nets (area weight " + std::to_string(areaWeight) + ", wirelength weight " +
+                std::to_string(wirelengthWeight) + ")");
+        }
         
         /********************************************************************
-         * PHASE 3: Run global placement with slicing algorithm
+         * PHASE 3: Run global placement with the selected engine
          ********************************************************************/
         Logger::log("PHASE 3: Running global placement optimization");
+        HW4_PROFILE_NEXT_STAGE(phase, "PlacementSolver::solve/phase 3 global placement");
         
         // Calculate remaining time
         auto currentTime = std::chrono::steady_clock::now();
         std::chrono::duration<double> elapsed = currentTime - startTime;
         int remainingTimeSeconds = timeLimit - static_cast<int>(elapsed.count());
         
-        // Run the optimizer
-        optimizer->run();
+        // Every engine anneals until 30 s before the limit, which leaves time
+        // for legalization, compaction and output
+        const int engineTimeLimit = std::max(1, remainingTimeSeconds - 30);
         
-        // Get the best solution from the slicing algorithm
-        FloorplanSolution* slicingSolution = optimizer->getBestSolution();
-        
-        if (!slicingSolution) {
-            Logger::log("ERROR: No solution found by slicing algorithm");
-            return false;
+        if (placementEngine == PlacementEngine::SEQUENCE_PAIR) {
+            SequencePairAnnealer annealer(floorplanData.get());
+            annealer.setTimeLimit(engineTimeLimit);
+            if (useWirelength) {
+                annealer.setWirelengthModel(&blockWirelength, areaWeight, wirelengthWeight);
+            }
+            
+            // Leaves the best packing in the blocks
+            annealer.run();
+        } else if (placementEngine == PlacementEngine::BSTAR_TREE) {
+            BStarTreeAnnealer annealer(floorplanData.get());
+            annealer.setTimeLimit(engineTimeLimit);
+            if (useWirelength) {
+                annealer.setWirelengthModel(&blockWirelength, areaWeight, wirelengthWeight);
+            }
+            
+            annealer.run();
+        } else if (placementEngine == PlacementEngine::MULTILEVEL) {
+            MultilevelAnnealer annealer(floorplanData.get());
+            annealer.setTimeLimit(engineTimeLimit);
+            if (useWirelength) {
+                annealer.setWirelengthModel(&blockWirelength, areaWeight, wirelengthWeight);
+            }
+            
+            annealer.run();
+        } else {
+            // Create and configure Simulated Annealing solver for slicing
+            auto optimizer = std::make_unique<SimulatedAnnealing>(floorplanData.get());
+            optimizer->setTimeLimit(engineTimeLimit);
+            if (useWirelength) {
+                optimizer->setWirelengthModel(&blockWirelength, areaWeight, wirelengthWeight);
+            }
+            
+            // Run the optimizer
+            optimizer->run();
+            
+            // Get the best solution from the slicing algorithm
+            FloorplanSolution* slicingSolution = optimizer->getBestSolution();
+            
+            if (!slicingSolution) {
+                Logger::log("ERROR: No solution found by slicing algorithm");
+                return false;
+            }
         }
         
         /********************************************************************
-         * PHASE 4: Apply the slicing solution to our modules
+         * PHASE 4: Apply the global placement solution to our modules
          ********************************************************************/
         Logger::log("PHASE 4: Applying global placement solution to modules");
+        HW4_PROFILE_NEXT_STAGE(phase, "PlacementSolver::solve/phase 4 apply and compact");
         
-        // Apply the slicing solution to our modules
+        // Apply the block positions to our modules
         for (int i = 0; i < floorplanData->getNumBlocks(); i++) {
             Block* block = floorplanData->getBlock(i);
             if (!block) continue;
@@ -1744,11 +1678,10 @@ bool PlacementSolver::solve() {
             int x = block->getX();
             int y = block->getY();
             
-            auto mapIt = blockMapping.find(i);
-            if (mapIt == blockMapping.end()) continue;
+            if (i >= static_cast<int>(blockMapping.size())) continue;
             
-            bool isIsland = mapIt->second.first;
-            size_t entityIdx = mapIt->second.second;
+            bool isIsland = blockMapping[i].first;
+            size_t entityIdx = blockMapping[i].second;
             
             if (isIsland) {
                 // This block represents a symmetry island
@@ -1774,27 +1707,27 @@ bool PlacementSolver::solve() {
                         (isRotated ? " (rotated)" : ""));
                 }
             } else {
-                // This block represents a regular module
-                auto moduleIt = std::next(regularModules.begin(), entityIdx);
+                // This block views the regular module's geometry, so the
+                // engine already placed the module
+                auto moduleIt = regularModules.find(static_cast<ModuleId>(entityIdx));
                 if (moduleIt != regularModules.end()) {
-                    auto& moduleName = moduleIt->first;
                     auto module = moduleIt->second;
                     
-                    // Set rotation and position
-                    module->setRotation(isRotated);
-                    module->setPosition(x, y);
-                    
-                    Logger::log("Positioned regular module " + moduleName + 
+                    Logger::log("Positioned regular module " + module->getName() + 
                         " at (" + std::to_string(x) + "," + std::to_string(y) + ")" +
                         (isRotated ? " (rotated)" : ""));
                 }
             }
         }
         
+        // Squeeze out slack the global placer left between blocks
+        compactPlacement();
+        
         /********************************************************************
          * PHASE 5: Calculate final metrics and update best solution
          ********************************************************************/
         Logger::log("PHASE 5: Calculating final metrics");
+        HW4_PROFILE_NEXT_STAGE(phase, "PlacementSolver::solve/phase 5 metrics");
         
         // Calculate final area and wirelength
         solutionArea = calculateArea();
@@ -1803,71 +1736,20 @@ bool PlacementSolver::solve() {
         // Update best solution
         updateBestSolution();
         
-        // Check for overlaps
-        bool hasOverlaps = false;
-        // Check regular modules vs regular modules
-        for (const auto& pair1 : regularModules) {
-            const auto& module1 = pair1.second;
-            int m1Left = module1->getX();
-            int m1Right = m1Left + module1->getWidth();
-            int m1Bottom = module1->getY();
-            int m1Top = m1Bottom + module1->getHeight();
-            
-            // Check against other modules
-            for (const auto& pair2 : regularModules) {
-                if (pair1.first == pair2.first) continue; // Skip self
-                
-                const auto& module2 = pair2.second;
-                int m2Left = module2->getX();
-                int m2Right = m2Left + module2->getWidth();
-                int m2Bottom = module2->getY();
-                int m2Top = m2Bottom + module2->getHeight();
-                
-                if (!(m1Right <= m2Left || m2Right <= m1Left || 
-                      m1Top <= m2Bottom || m2Top <= m1Bottom)) {
-                    Logger::log("ERROR: Overlap detected between " + pair1.first + 
-                        " and " + pair2.first);
-                    hasOverlaps = true;
-                }
-            }
-            
-            // Check against symmetry islands
-            for (const auto& island : symmetryIslands) {
-                int islandLeft = island->getX();
-                int islandRight = islandLeft + island->getWidth();
-                int islandBottom = island->getY();
-                int islandTop = islandBottom + island->getHeight();
-                
-                if (!(m1Right <= islandLeft || islandRight <= m1Left || 
-                      m1Top <= islandBottom || islandTop <= m1Bottom)) {
-                    Logger::log("ERROR: Overlap detected between " + pair1.first + 
-                        " and symmetry island");
-                    hasOverlaps = true;
-                }
-            }
+        // Check for overlaps (sweep line over modules and islands)
+        loadOverlapDetector();
+        const auto& overlaps = overlapDetector.findOverlaps();
+        bool hasOverlaps = !overlaps.empty();
+        for (const auto& pair : overlaps) {
+            Logger::log("ERROR: Overlap detected between " + getOverlapEntityName(pair.first) +
+                " and " + getOverlapEntityName(pair.second));
         }
         
-        // Check symmetry islands vs symmetry islands
+        // The detector only sees island bounding boxes, so check inside each island too
         for (size_t i = 0; i < symmetryIslands.size(); i++) {
-            const auto& island1 = symmetryIslands[i];
-            int i1Left = island1->getX();
-            int i1Right = i1Left + island1->getWidth();
-            int i1Bottom = island1->getY();
-            int i1Top = i1Bottom + island1->getHeight();
-            
-            for (size_t j = i + 1; j < symmetryIslands.size(); j++) {
-                const auto& island2 = symmetryIslands[j];
-                int i2Left = island2->getX();
-                int i2Right = i2Left + island2->getWidth();
-                int i2Bottom = island2->getY();
-                int i2Top = i2Bottom + island2->getHeight();
-                
-                if (!(i1Right <= i2Left || i2Right <= i1Left || 
-                      i1Top <= i2Bottom || i2Top <= i1Bottom)) {
-                    Logger::log("ERROR: Overlap detected between symmetry islands " + 
-                        std::to_string(i) + " and " + std::to_string(j));
-                    hasOverlaps = true;
-                }
+            if (symmetryIslands[i] && !symmetryIslands[i]->getASFBStarTree()->validateNoOverlaps()) {
+                Logger::log("ERROR: Modules overlap inside symmetry island " + std::to_string(i));
+                hasOverlaps = true;
             }
         }
         
@@ -1877,8 +1759,17 @@ bool PlacementSolver::solve() {
             Logger::log("Final solution has no overlaps");
         }
         
+        if (outline.isFixed()) {
+            int width, height;
+            calculateBoundingBox(width, height);
+            Logger::log("Fixed outline " + std::to_string(outline.width) + "x" + std::to_string(outline.height) +
+                ": placement is " + std::to_string(width) + "x" + std::to_string(height) +
+                (outline.fits(width, height) ? ", fits" : ", does NOT fit"));
+        }
+        
         // Log final solution statistics
-        Logger::log("Final solution - Area: " + std::to_string(solutionArea));
+        Logger::log("Final solution - Area: " + std::to_string(solutionArea) +
+            ", HPWL: " + std::to_string(solutionWirelength));
         
         // Calculate execution time
         auto endTime = std::chrono::steady_clock::now();
@@ -1902,171 +1793,71 @@ bool PlacementSolver::solve() {
  * This is a simplified version of the repairFloorplan method from the slicing algorithm
  */
 bool PlacementSolver::repairOverlaps() {
+    ChromeTrace::Scope trace("repairOverlaps", "legalize");
     Logger::log("Attempting to repair overlaps in placement");
     
     bool hasOverlaps = true;
     int iterations = 0;
     const int maxIterations = 300;
     
-    std::vector<std::pair<void*, std::pair<int, int>>> originalPositions;
-    
-    // Store original positions
-    for (const auto& pair : regularModules) {
-        const auto& module = pair.second;
-        originalPositions.push_back({module.get(), {module->getX(), module->getY()}});
-    }
-    
-    for (const auto& island : symmetryIslands) {
-        originalPositions.push_back({island.get(), {island->getX(), island->getY()}});
+    // Store original positions, indexed by overlap entity id
+    loadOverlapDetector();
+    size_t numEntities = overlapModules.size() + symmetryIslands.size();
+    std::vector<std::pair<int, int>> originalPositions(numEntities);
+    for (size_t id = 0; id < numEntities; id++) {
+        int width, height;
+        getOverlapEntityRect(static_cast<int>(id), originalPositions[id].first,
+                             originalPositions[id].second, width, height);
     }
     
     while (hasOverlaps && iterations < maxIterations) {
-        hasOverlaps = false;
         iterations++;
         
-        // First check for overlaps between regular modules
-        for (auto& pair1 : regularModules) {
-            auto& module1 = pair1.second;
-            int m1Left = module1->getX();
-            int m1Right = m1Left + module1->getWidth();
-            int m1Bottom = module1->getY();
-            int m1Top = m1Bottom + module1->getHeight();
+        // Report all overlapping pairs at once and fix them in one batch
+        loadOverlapDetector();
+        const auto& overlaps = overlapDetector.findOverlaps();
+        hasOverlaps = !overlaps.empty();
+        
+        for (const auto& pair : overlaps) {
+            // Islands are moved only when two islands overlap
+            int first = pair.first;
+            int second = pair.second;
+            bool firstIsModule = static_cast<size_t>(first) < overlapModules.size();
+            bool secondIsModule = static_cast<size_t>(second) < overlapModules.size();
+            if (!firstIsModule && secondIsModule) {
+                std::swap(first, second);
+                std::swap(firstIsModule, secondIsModule);
+            }
             
-            // Check against other modules
-            for (auto& pair2 : regularModules) {
-                if (pair1.first == pair2.first) continue; // Skip self
-                
-                auto& module2 = pair2.second;
-                int m2Left = module2->getX();
-                int m2Right = m2Left + module2->getWidth();
-                int m2Bottom = module2->getY();
-                int m2Top = m2Bottom + module2->getHeight();
-                
-                // Check for overlap
-                if (!(m1Right <= m2Left || m2Right <= m1Left || 
-                     m1Top <= m2Bottom || m2Top <= m1Bottom)) {
-                    
-                    hasOverlaps = true;
-                    
-                    // Calculate overlap in both x and y directions
-                    int overlapX = std::min(m1Right, m2Right) - std::max(m1Left, m2Left);
-                    int overlapY = std::min(m1Top, m2Top) - std::max(m1Bottom, m2Bottom);
-                    
-                    // Move along direction with smallest overlap
-                    if (overlapX <= overlapY) {
-                        // Horizontal shift
-                        if (m1Left < m2Left) {
-                            module1->setPosition(m1Left - overlapX - 1, module1->getY());
-                        } else {
-                            module1->setPosition(m2Left - overlapX - 1, module2->getY());
-                        }
-                    } else {
-                        // Vertical shift
-                        if (m1Bottom < m2Bottom) {
-                            module1->setPosition(module1->getX(), m1Bottom - overlapY - 1);
-                        } else {
-                            module2->setPosition(module2->getX(), m2Bottom - overlapY - 1);
-                        }
-                    }
-                    
-                    // Only fix one overlap per iteration to avoid oscillation
-                    break;
-                }
+            // An earlier fix in this batch may already have separated the pair
+            int x1, y1, w1, h1, x2, y2, w2, h2;
+            getOverlapEntityRect(first, x1, y1, w1, h1);
+            getOverlapEntityRect(second, x2, y2, w2, h2);
+            if (x1 + w1 <= x2 || x2 + w2 <= x1 || y1 + h1 <= y2 || y2 + h2 <= y1) {
+                continue;
             }
             
-            if (hasOverlaps) break;
+            // Calculate overlap in both x and y directions
+            int overlapX = std::min(x1 + w1, x2 + w2) - std::max(x1, x2);
+            int overlapY = std::min(y1 + h1, y2 + h2) - std::max(y1, y2);
             
-            // Check against symmetry islands
-            for (auto& island : symmetryIslands) {
-                int islandLeft = island->getX();
-                int islandRight = islandLeft + island->getWidth();
-                int islandBottom = island->getY();
-                int islandTop = islandBottom + island->getHeight();
-                
-                // Check for overlap
-                if (!(m1Right <= islandLeft || islandRight <= m1Left || 
-                     m1Top <= islandBottom || islandTop <= m1Bottom)) {
-                    
-                    hasOverlaps = true;
-                    
-                    // Calculate overlap in both x and y directions
-                    int overlapX = std::min(m1Right, islandRight) - std::max(m1Left, islandLeft);
-                    int overlapY = std::min(m1Top, islandTop) - std::max(m1Bottom, islandBottom);
-                    
-                    // Move along direction with smallest overlap
-                    if (overlapX <= overlapY) {
-                        // Horizontal shift - prefer moving the module, not the island
-                        if (m1Left < islandLeft) {
-                            module1->setPosition(m1Left - overlapX - 1, module1->getY());
-                        } else {
-                            module1->setPosition(islandRight + 1, module1->getY());
-                        }
-                    } else {
-                        // Vertical shift
-                        if (m1Bottom < islandBottom) {
-                            module1->setPosition(module1->getX(), m1Bottom - overlapY - 1);
-                        } else {
-                            module1->setPosition(module1->getX(), islandTop + 1);
-                        }
-                    }
-                    
-                    // Only fix one overlap per iteration
-                    break;
+            if (firstIsModule && !secondIsModule) {
+                // Module vs island: move the module, not the island
+                if (overlapX <= overlapY) {
+                    setOverlapEntityPosition(first, x1 < x2 ? x1 - overlapX - 1 : x2 + w2 + 1, y1);
+                } else {
+                    setOverlapEntityPosition(first, x1, y1 < y2 ? y1 - overlapY - 1 : y2 + h2 + 1);
                 }
-            }
-            
-            if (hasOverlaps) break;
-        }
-        
-        // Check for overlaps between symmetry islands
-        if (!hasOverlaps) {
-            for (size_t i = 0; i < symmetryIslands.size(); i++) {
-                auto& island1 = symmetryIslands[i];
-                int i1Left = island1->getX();
-                int i1Right = i1Left + island1->getWidth();
-                int i1Bottom = island1->getY();
-                int i1Top = i1Bottom + island1->getHeight();
-                
-                for (size_t j = i + 1; j < symmetryIslands.size(); j++) {
-                    auto& island2 = symmetryIslands[j];
-                    int i2Left = island2->getX();
-                    int i2Right = i2Left + island2->getWidth();
-                    int i2Bottom = island2->getY();
-                    int i2Top = i2Bottom + island2->getHeight();
-                    
-                    // Check for overlap
-                    if (!(i1Right <= i2Left || i2Right <= i1Left || 
-                         i1Top <= i2Bottom || i2Top <= i1Bottom)) {
-                        
-                        hasOverlaps = true;
-                        
-                        // Calculate overlap in both x and y directions
-                        int overlapX = std::min(i1Right, i2Right) - std::max(i1Left, i2Left);
-                        int overlapY = std::min(i1Top, i2Top) - std::max(i1Bottom, i2Bottom);
-                        
-                        // Move along direction with smallest overlap
-                        if (overlapX <= overlapY) {
-                            // Horizontal shift
-                            if (i1Left < i2Left) {
-                                island1->setPosition(i1Left - overlapX - 1, i1Bottom);
-                            } else {
-                                island2->setPosition(i2Left - overlapX - 1, i2Bottom);
-                            }
-                        } else {
-                            // Vertical shift
-                            if (i1Bottom < i2Bottom) {
-                                island1->setPosition(i1Left, i1Bottom - overlapY - 1);
-                            } else {
-                                island2->setPosition(i2Left, i2Bottom - overlapY - 1);
-                            }
-                        }
-                        
-                        // Only fix one overlap per iteration
-                        break;
-                    }
+            } else {
+                // Same kind: move whichever lies further left / lower away
+                int mover = (overlapX <= overlapY ? x1 < x2 : y1 < y2) ? first : second;
+                int mx = mover == first ? x1 : x2;
+                int my = mover == first ? y1 : y2;
+                if (overlapX <= overlapY) {
+                    setOverlapEntityPosition(mover, mx - overlapX - 1, my);
+                } else {
+                    setOverlapEntityPosition(mover, mx, my - overlapY - 1);
                 }
-                
-                if (hasOverlaps) break;
             }
         }
         
@@ -2078,15 +1869,11 @@ bool PlacementSolver::repairOverlaps() {
             int spreadFactor = iterations / 50 * 10; // Increases as iterations increase
             
             // Sort all modules/islands by area (largest first)
-            std::vector<std::pair<void*, int>> entitiesByArea;
-            
-            for (const auto& pair : regularModules) {
-                const auto& module = pair.second;
-                entitiesByArea.push_back({module.get(), module->getWidth() * module->getHeight()});
-            }
-            
-            for (const auto& island : symmetryIslands) {
-                entitiesByArea.push_back({island.get(), island->getWidth() * island->getHeight()});
+            std::vector<std::pair<int, Area>> entitiesByArea;
+            for (size_t id = 0; id < numEntities; id++) {
+                int x, y, width, height;
+                getOverlapEntityRect(static_cast<int>(id), x, y, width, height);
+                entitiesByArea.push_back({static_cast<int>(id), areaOf(width, height)});
             }
             
             std::sort(entitiesByArea.begin(), entitiesByArea.end(), 
@@ -2101,30 +1888,9 @@ bool PlacementSolver::repairOverlaps() {
             int rowMaxHeight = 0;
             
             for (const auto& entity : entitiesByArea) {
-                int width, height;
-                
-                // Check if it's a module or island
-                bool isModule = false;
-                for (const auto& pair : regularModules) {
-                    if (pair.second.get() == entity.first) {
-                        isModule = true;
-                        width = pair.second->getWidth();
-                        height = pair.second->getHeight();
-                        pair.second->setPosition(gridX, gridY);
-                        break;
-                    }
-                }
-                
-                if (!isModule) {
-                    for (size_t i = 0; i < symmetryIslands.size(); i++) {
-                        if (symmetryIslands[i].get() == entity.first) {
-                            width = symmetryIslands[i]->getWidth();
-                            height = symmetryIslands[i]->getHeight();
-                            symmetryIslands[i]->setPosition(gridX, gridY);
-                            break;
-                        }
-                    }
-                }
+                int x, y, width, height;
+                getOverlapEntityRect(entity.first, x, y, width, height);
+                setOverlapEntityPosition(entity.first, gridX, gridY);
                 
                 // Update grid position
                 gridX += width + spreadFactor;
@@ -2141,109 +1907,17 @@ bool PlacementSolver::repairOverlaps() {
     }
     
     // Final check for overlaps
-    hasOverlaps = false;
-    
-    // Check regular modules vs regular modules
-    for (const auto& pair1 : regularModules) {
-        const auto& module1 = pair1.second;
-        int m1Left = module1->getX();
-        int m1Right = m1Left + module1->getWidth();
-        int m1Bottom = module1->getY();
-        int m1Top = m1Bottom + module1->getHeight();
-        
-        // Check against other modules
-        for (const auto& pair2 : regularModules) {
-            if (pair1.first == pair2.first) continue; // Skip self
-            
-            const auto& module2 = pair2.second;
-            int m2Left = module2->getX();
-            int m2Right = m2Left + module2->getWidth();
-            int m2Bottom = module2->getY();
-            int m2Top = m2Bottom + module2->getHeight();
-            
-            if (!(m1Right <= m2Left || m2Right <= m1Left || 
-                 m1Top <= m2Bottom || m2Top <= m1Bottom)) {
-                hasOverlaps = true;
-                break;
-            }
-        }
-        
-        if (hasOverlaps) break;
-        
-        // Check against symmetry islands
-        for (const auto& island : symmetryIslands) {
-            int islandLeft = island->getX();
-            int islandRight = islandLeft + island->getWidth();
-            int islandBottom = island->getY();
-            int islandTop = islandBottom + island->getHeight();
-            
-            if (!(m1Right <= islandLeft || islandRight <= m1Left || 
-                 m1Top <= islandBottom || islandTop <= m1Bottom)) {
-                hasOverlaps = true;
-                break;
-            }
-        }
-        
-        if (hasOverlaps) break;
-    }
-    
-    // Check symmetry islands vs symmetry islands
-    if (!hasOverlaps) {
-        for (size_t i = 0; i < symmetryIslands.size(); i++) {
-            const auto& island1 = symmetryIslands[i];
-            int i1Left = island1->getX();
-            int i1Right = i1Left + island1->getWidth();
-            int i1Bottom = island1->getY();
-            int i1Top = i1Bottom + island1->getHeight();
-            
-            for (size_t j = i + 1; j < symmetryIslands.size(); j++) {
-                const auto& island2 = symmetryIslands[j];
-                int i2Left = island2->getX();
-                int i2Right = i2Left + island2->getWidth();
-                int i2Bottom = island2->getY();
-                int i2Top = i2Bottom + island2->getHeight();
-                
-                if (!(i1Right <= i2Left || i2Right <= i1Left || 
-                     i1Top <= i2Bottom || i2Top <= i1Bottom)) {
-                    hasOverlaps = true;
-                    break;
-                }
-            }
-            
-            if (hasOverlaps) break;
-        }
-    }
+    loadOverlapDetector();
+    hasOverlaps = overlapDetector.hasOverlap();
     
     // If still has overlaps, revert to original positions
     if (hasOverlaps && iterations >= maxIterations) {
         Logger::log("Overlap repair failed after " + std::to_string(iterations) + 
                   " iterations. Reverting to original positions.");
         
-        // Restore original positions
-        for (const auto& entry : originalPositions) {
-            void* entity = entry.first;
-            int x = entry.second.first;
-            int y = entry.second.second;
-            
-            // Check if it's a module
-            bool found = false;
-            for (auto& pair : regularModules) {
-                if (pair.second.get() == entity) {
-                    pair.second->setPosition(x, y);
-                    found = true;
-                    break;
-                }
-            }
-            
-            // If not found, must be an island
-            if (!found) {
-                for (auto& island : symmetryIslands) {
-                    if (island.get() == entity) {
-                        island->setPosition(x, y);
-                        break;
-                    }
-                }
-            }
+        for (size_t id = 0; id < numEntities; id++) {
+            setOverlapEntityPosition(static_cast<int>(id), originalPositions[id].first,
+                                     originalPositions[id].second);
         }
         
         return false;
@@ -2254,11 +1928,16 @@ bool PlacementSolver::repairOverlaps() {
 }
 
 // Get solution area
-int PlacementSolver::getSolutionArea() const {
+Area PlacementSolver::getSolutionArea() const {
     return solutionArea;
 }
 
+// Get solution wirelength
+double PlacementSolver::getSolutionWirelength() const {
+    return solutionWirelength;
+}
+
 // Get solution modules
-const std::map<std::string, std::shared_ptr<Module>>& PlacementSolver::getSolutionModules() const {
-    return bestSolutionModules;
+const std::map<ModuleId, std::shared_ptr<Module>>& PlacementSolver::getSolutionModules() const {
+    return modules;
 }
\ No newline at end of file
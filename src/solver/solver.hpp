@@ -14,8 +14,28 @@
 #include "../data_struct/ASFBStarTree.hpp"
 #include "../data_struct/SymmetryIslandBlock.hpp"
 #include "../data_struct/BStarTree.hpp"
+#include "../data_struct/Contour.hpp"
+#include "../data_struct/IslandLibrary.hpp"
+#include "../data_struct/Net.hpp"
+#include "../data_struct/HPWLEvaluator.hpp"
+#include "../data_struct/OverlapDetector.hpp"
+#include "../data_struct/Compactor.hpp"
+#include "../data_struct/Outline.hpp"
 #include "../slicing/slicing_struct.hpp" 
 #include "../slicing/slicing_sa.hpp" 
+#include "../seqpair/seqpair_sa.hpp"
+#include "../bstar/bstar_sa.hpp"
+#include "../multilevel/multilevel_sa.hpp"
+
+/**
+ * @brief Global placement engine run in Phase 3 of PlacementSolver::solve()
+ */
+enum class PlacementEngine {
+    SLICING,        // Polish expressions with shape records (default)
+    SEQUENCE_PAIR,  // Sequence pairs; also represents non-slicing packings
+    BSTAR_TREE,     // Array-based B*-tree with contour packing
+    MULTILEVEL      // B*-tree over clustered blocks, refined level by level
+};
 
 /**
  * @brief Placement solver using simulated annealing
@@ -27,14 +47,20 @@
 class PlacementSolver {
 public:
     // Input data
-    std::map<std::string, std::shared_ptr<Module>> modules;
+    std::map<ModuleId, std::shared_ptr<Module>> modules;
     std::vector<std::shared_ptr<SymmetryGroup>> symmetryGroups;
     
+    std::vector<Net> nets;
+    
+    // Wirelength over the absolute module positions; object i is wirelengthModules[i]
+    HPWLEvaluator moduleWirelength;
+    std::vector<std::shared_ptr<Module>> wirelengthModules;
+    
     // Symmetry islands (one for each symmetry group)
     std::vector<std::shared_ptr<SymmetryIslandBlock>> symmetryIslands;
     
     // Regular modules (not in symmetry groups)
-    std::map<std::string, std::shared_ptr<Module>> regularModules;
+    std::map<ModuleId, std::shared_ptr<Module>> regularModules;
     
     // B*-tree for global placement
     struct BStarNode {
@@ -72,13 +98,37 @@ public:
     void printBStarTree(BStarNode *node, std::string prefix, bool isLast);
     
     // Current solution
-    std::map<std::string, std::shared_ptr<Module>> solutionModules;
-    int solutionArea;
+    Area solutionArea;
     double solutionWirelength;
     
+    /**
+     * @brief Module placement stored as flat arrays indexed by module id
+     * 
+     * The arrays are sized once when the problem is loaded. Taking a
+     * snapshot copies the module geometry's position and rotation arrays
+     * in place, so recording an improvement does not allocate, and
+     * restoring copies them back.
+     */
+    struct PlacementSnapshot {
+        std::vector<int> x;
+        std::vector<int> y;
+        std::vector<char> rotated;
+        unsigned long long generation = 0;  // Snapshots taken so far; 0 if none
+        
+        void resize(size_t n) {
+            x.assign(n, 0);
+            y.assign(n, 0);
+            rotated.assign(n, 0);
+            generation = 0;
+        }
+    };
+    
+    // Geometry of every module, indexed by module id (shared with the modules)
+    std::shared_ptr<GeometryStore> moduleGeometry;
+    
     // Best solution found so far
-    std::map<std::string, std::shared_ptr<Module>> bestSolutionModules;
-    int bestSolutionArea;
+    PlacementSnapshot bestPlacement;
+    Area bestSolutionArea;
     double bestSolutionWirelength;
     
     // Simulated annealing parameters
@@ -106,16 +156,19 @@ public:
     int timeLimit;
     std::chrono::steady_clock::time_point startTime;
     
-    // Contour data structure for packing
-    struct ContourPoint {
-        int x;
-        int height;
-        ContourPoint* next;
-        
-        ContourPoint(int x, int height) : x(x), height(height), next(nullptr) {}
-    };
+    // Engine used for global placement
+    PlacementEngine placementEngine;
+    
+    // Fixed outline the placement should fit in (unbounded by default)
+    Outline outline;
     
-    ContourPoint* contourHead;
+    // Persistent cache of packed island layouts (disabled if the path is empty)
+    std::string islandLibraryPath;
+    IslandLibrary islandLibrary;
+    
+    // Skyline contour for packing (shared implementation with the ASF-B*-tree)
+    Contour contour;
+    std::vector<int> contourBreakpoints;
     
     // Preorder and inorder traversals for B*-tree
     std::vector<BStarNode*> preorderTraversal;
@@ -129,6 +182,9 @@ public:
     void safeInorder(BStarNode* node);
     BStarNode* findNodeByName(const std::string& name);
     
+    // Regular module behind a global B*-tree node name, nullptr if there is none
+    std::shared_ptr<Module> findRegularModule(const std::string& name) const;
+    
     /**
      * Cleans up the B*-tree
      * 
@@ -137,19 +193,16 @@ public:
     void cleanupBStarTree(BStarNode* node);
     
     /**
-     * Clears the contour data structure
+     * Gets the width and height of the module or island behind a B*-tree node
+     * 
+     * @return False if the node does not refer to a known module or island
      */
-    void clearContour();
+    bool getNodeDimensions(BStarNode* node, int& width, int& height);
     
     /**
-     * Updates the contour after placing a module
-     * 
-     * @param x X-coordinate of the module
-     * @param y Y-coordinate of the module
-     * @param width Width of the module
-     * @param height Height of the module
+     * Places the module or island behind a B*-tree node
      */
-    void updateContour(int x, int y, int width, int height);
+    void setNodePosition(BStarNode* node, int x, int y);
     
     /**
      * Gets the height of the contour at a given x-coordinate
@@ -184,20 +237,44 @@ public:
      */
     void packBStarTree();
     
+    /**
+     * Calculates the bounding box of the current placement, from the origin
+     * 
+     * @param width Set to the bounding box width
+     * @param height Set to the bounding box height
+     */
+    void calculateBoundingBox(int& width, int& height);
+    
     /**
      * Calculates the bounding box area of the current placement
      * 
      * @return Area of the bounding box
      */
-    int calculateArea();
+    Area calculateArea();
     
     /**
-     * Calculates the half-perimeter wirelength (placeholder)
+     * Calculates the half-perimeter wirelength of the nets
+     * 
+     * Incremental: only nets on modules that moved since the last call are
+     * recomputed.
      * 
-     * @return Half-perimeter wirelength
+     * @return Half-perimeter wirelength (0 without nets)
      */
     double calculateWirelength();
     
+    /**
+     * Builds the wirelength model of the slicing stage, where every net pin
+     * rides on the slicing block of its module or symmetry island
+     * 
+     * @param model Model to fill; object i is slicing block i
+     * @param numBlocks Number of slicing blocks
+     * @param islandBlocks Slicing block index of each symmetry island
+     * @param moduleBlocks Slicing block index by module id, -1 if not a regular module
+     */
+    void buildBlockWirelengthModel(HPWLEvaluator& model, int numBlocks,
+                                   const std::vector<int>& islandBlocks,
+                                   const std::vector<int>& moduleBlocks);
+    
     /**
      * Calculates the cost of the current solution
      * 
@@ -259,14 +336,34 @@ public:
      */
     bool hasOverlaps();
     
+    // Sweep-line overlap detection; entity ids [0, R) are overlapModules
+    // (the regular modules), [R, R + islands) the symmetry islands
+    OverlapDetector overlapDetector;
+    std::vector<std::shared_ptr<Module>> overlapModules;
+    
     /**
-     * Performs deep copy of module data
+     * Loads the current regular module and island rectangles into overlapDetector
+     */
+    void loadOverlapDetector();
+    
+    bool getOverlapEntityRect(int id, int& x, int& y, int& width, int& height) const;
+    void setOverlapEntityPosition(int id, int x, int y);
+    std::string getOverlapEntityName(int id) const;
+    
+    // Post-placement compaction over the same entities as overlapDetector
+    Compactor compactor;
+    
+    /**
+     * Removes slack left by the global placer with constraint-graph
+     * compaction; symmetry islands move as rigid blocks
+     * 
+     * The placement must be overlap-free. The result is kept only if it
+     * does not raise the cost.
      * 
-     * @param source Source map of modules
-     * @return New map with copied modules
+     * @return True if the placement changed
      */
-    std::map<std::string, std::shared_ptr<Module>> copyModules(const std::map<std::string, std::shared_ptr<Module>> &source);
-
+    bool compactPlacement();
+    
     void backupBStarTree();
 
     void restoreBStarTree();
@@ -278,12 +375,12 @@ public:
     BStarNode* findRandomNode();
     
     /**
-     * Copies the current solution to the best solution
+     * Records the current module placement as the best solution
      */
     void updateBestSolution();
     
     /**
-     * Copies the best solution to the current solution
+     * Moves every module back to the best placement recorded
      */
     void restoreBestSolution();
     
@@ -304,10 +401,12 @@ public:
      * 
      * @param modules Map of all modules
      * @param symmetryGroups Vector of symmetry groups
+     * @param nets Nets for the wirelength cost (optional)
      * @return True if loading was successful
      */
-    bool loadProblem(const std::map<std::string, std::shared_ptr<Module>>& modules, 
-                     const std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups);
+    bool loadProblem(const std::map<ModuleId, std::shared_ptr<Module>>& modules, 
+                     const std::vector<std::shared_ptr<SymmetryGroup>>& symmetryGroups,
+                     const std::vector<Net>& nets = std::vector<Net>());
     
     /**
      * Sets simulated annealing parameters
@@ -355,6 +454,35 @@ public:
      */
     void setTimeLimit(int seconds);
     
+    /**
+     * Selects the global placement engine
+     * 
+     * @param engine Slicing (default), sequence pair, B*-tree or multilevel
+     */
+    void setPlacementEngine(PlacementEngine engine);
+    
+    /**
+     * Enables fixed-outline mode
+     * 
+     * Every engine then penalizes area outside the width x height outline
+     * anchored at the origin, and the slicing shape curves drop shapes that
+     * do not fit. Whether the final placement fits is logged.
+     * 
+     * @param width Outline width
+     * @param height Outline height
+     */
+    void setFixedOutline(int width, int height);
+    
+    /**
+     * Enables the persistent island layout library
+     * 
+     * Must be called before loadProblem(). Islands found in the library are
+     * placed from the cached layout; the others are packed and added to it.
+     * 
+     * @param path Library file; created on first use
+     */
+    void setIslandLibraryPath(const std::string& path);
+    
     /**
      * Solves the placement problem
      * 
@@ -371,12 +499,21 @@ public:
      *
      * @return Area of the solution
      */
-    int getSolutionArea() const;
+    Area getSolutionArea() const;
+    
+    /**
+     * Gets the solution wirelength
+     *
+     * @return Half-perimeter wirelength of the solution
+     */
+    double getSolutionWirelength() const;
     
     /**
      * Gets the solution modules
      * 
+     * solve() leaves every module at the best placement it found.
+     * 
      * @return Map of modules with their final positions
      */
-    const std::map<std::string, std::shared_ptr<Module>>& getSolutionModules() const;
+    const std::map<ModuleId, std::shared_ptr<Module>>& getSolutionModules() const;
 };
\ No newline at end of file